@@ -0,0 +1,266 @@
+#include "Benchmark.h"
+
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Camera.h"
+#include "Clock.h"
+#include "CubeRenderer.h"
+#include "Framebuffer.h"
+#include "HeadlessContext.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+#include "RubiksCube.h"
+#include "Simulation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Where the time of a frame goes, measured on the calling thread
+enum BenchmarkPhase
+{
+    PHASE_SIMULATE, // queueing turns, simulation steps, taking the snapshot
+    PHASE_RENDER,   // issuing the GL commands
+    PHASE_GPU,      // waiting for the GPU to finish them
+    PHASE_PRESENT,  // --vsync only: waiting for the next display refresh
+    PHASE_COUNT
+};
+
+static const char* PHASE_NAMES[PHASE_COUNT] = { "simulate", "render", "gpu", "present" };
+
+// The scenario runs at this rate, as does the simulated display for --vsync
+static const double FRAME_TIME = 1.0 / 60.0;
+
+struct BenchmarkResult
+{
+    std::vector<double> frameTimes; // milliseconds, in frame order
+    double phaseTimes[PHASE_COUNT] = {}; // milliseconds, whole run
+    RenderStats render; // whole run
+    unsigned int maxDrawCalls = 0;
+    int turns = 0;
+    std::string renderer; // GL_RENDERER
+};
+
+// Uniform over every layer turn, independent of the standard library's distributions
+static Move RandomMove(std::mt19937& random, int cubeSize)
+{
+    Move move;
+    move.axis = (int)(random() % 3);
+    move.layer = (int)(random() % cubeSize);
+    move.quarterTurns = (random() % 2) ? 1 : -1;
+    return move;
+}
+
+// Nearest-rank percentile of sorted values
+static double Percentile(const std::vector<double>& sorted, double percent)
+{
+    if (sorted.empty())
+        return 0.0;
+    size_t rank = (size_t)std::ceil(percent / 100.0 * sorted.size());
+    return sorted[std::min(std::max(rank, (size_t)1), sorted.size()) - 1];
+}
+
+static double GetMilliseconds(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+{
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+static bool RunScenario(const AppOptions& options, BenchmarkResult& result)
+{
+    HeadlessContext context(options.glDebug != GLDebugLevel::Off);
+    if (!context.IsValid())
+        return false;
+    EnableGLDebugOutput(options.glDebug);
+
+    result.renderer = (const char*)glGetString(GL_RENDERER);
+
+    GLCall(glEnable(GL_DEPTH_TEST));
+    GLCall(glClearColor(0.2f, 0.3f, 0.3f, 1.0f));
+
+    int cubeSize = options.cubeSize;
+    Framebuffer target(options.width, options.height);
+    Camera camera = Camera::FrameCube(options.width, options.height, cubeSize);
+    CubeRenderer renderer(cubeSize);
+
+    std::mt19937 random(options.seed);
+    RubiksCube cube(cubeSize);
+    for (int i = 0; i < options.scramble; i++)
+        cube.ApplyMove(RandomMove(random, cubeSize));
+
+    // Stepped here from the fixed clock, as in an input replay
+    Simulation simulation(cube);
+    FixedClock clock(FRAME_TIME);
+
+    using Time = std::chrono::steady_clock;
+    Time::time_point start = Time::now();
+    result.frameTimes.reserve(options.frames);
+
+    // Setup uploads are not part of any frame
+    RenderStats::EndFrame();
+
+    for (int frame = 0; frame < options.frames; frame++)
+    {
+        PROFILE_SCOPE("Frame");
+        Time::time_point frameStart = Time::now();
+
+        clock.Advance();
+        int due = (int)(clock.GetTime() * options.turnRate);
+        for (; result.turns < due; result.turns++)
+        {
+            Move move = RandomMove(random, cubeSize);
+            simulation.Post([move](SimulationState& state) { state.moves.Push(move); });
+        }
+        simulation.Advance(clock.GetTime());
+        simulation.UpdateSnapshot();
+        Time::time_point simulated = Time::now();
+
+        // Slow orbit so no two frames show the same picture
+        float angle = (float)clock.GetTime() * glm::radians(30.0f);
+        glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), glm::radians(30.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+        rotation = glm::rotate(rotation, angle, glm::vec3(0.0f, 1.0f, 0.0f));
+
+        target.Bind();
+        GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        renderer.Draw(camera.GetViewProjectionMatrix(), rotation, simulation.GetSnapshot().draws);
+        Time::time_point rendered = Time::now();
+
+        GLCall(glFinish());
+        Time::time_point finished = Time::now();
+        RenderStats::EndFrame();
+
+        // No window to sync to: sleep to the next refresh of a 60 Hz display
+        if (options.vsync)
+        {
+            double refresh = std::ceil(GetMilliseconds(start, finished) / 1000.0 / FRAME_TIME) * FRAME_TIME;
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<Time::duration>(std::chrono::duration<double>(refresh)));
+        }
+        Time::time_point presented = Time::now();
+
+        result.phaseTimes[PHASE_SIMULATE] += GetMilliseconds(frameStart, simulated);
+        result.phaseTimes[PHASE_RENDER] += GetMilliseconds(simulated, rendered);
+        result.phaseTimes[PHASE_GPU] += GetMilliseconds(rendered, finished);
+        result.phaseTimes[PHASE_PRESENT] += GetMilliseconds(finished, presented);
+        result.frameTimes.push_back(GetMilliseconds(frameStart, presented));
+
+        result.render += RenderStats::GetLastFrame();
+        result.maxDrawCalls = std::max(result.maxDrawCalls, RenderStats::GetLastFrame().drawCalls);
+    }
+
+    target.Unbind();
+    return true;
+}
+
+static bool EndsWith(const std::string& text, const std::string& suffix)
+{
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static std::string EscapeJson(const std::string& text)
+{
+    std::string escaped;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+// One object per run
+static void WriteJson(std::ofstream& out, const AppOptions& options, const BenchmarkResult& result, const std::vector<double>& sorted)
+{
+    int frames = (int)result.frameTimes.size();
+    double total = 0.0;
+    for (double time : result.frameTimes)
+        total += time;
+
+    out << "{\n"
+        << "  \"renderer\": \"" << EscapeJson(result.renderer) << "\",\n"
+        << "  \"scenario\": { \"cube_size\": " << options.cubeSize << ", \"width\": " << options.width
+        << ", \"height\": " << options.height << ", \"frames\": " << frames << ", \"vsync\": " << (options.vsync ? "true" : "false")
+        << ", \"scramble\": " << options.scramble << ", \"turn_rate\": " << options.turnRate << ", \"seed\": " << options.seed << " },\n"
+        << "  \"frame_ms\": { \"mean\": " << total / frames << ", \"p50\": " << Percentile(sorted, 50.0)
+        << ", \"p90\": " << Percentile(sorted, 90.0) << ", \"p99\": " << Percentile(sorted, 99.0)
+        << ", \"max\": " << sorted.back() << " },\n"
+        << "  \"phase_ms\": {";
+    for (int phase = 0; phase < PHASE_COUNT; phase++)
+        out << (phase ? ", " : " ") << "\"" << PHASE_NAMES[phase] << "\": " << result.phaseTimes[phase] / frames;
+    out << " },\n"
+        << "  \"draw_calls\": { \"mean\": " << (double)result.render.drawCalls / frames << ", \"max\": " << result.maxDrawCalls << " },\n"
+        << "  \"per_frame\": { \"triangles\": " << (double)result.render.triangles / frames
+        << ", \"binds\": " << (double)result.render.binds / frames
+        << ", \"redundant_binds\": " << (double)result.render.redundantBinds / frames
+        << ", \"uniforms\": " << (double)result.render.uniformUploads / frames
+        << ", \"upload_bytes\": " << (double)(result.render.bufferBytes + result.render.textureBytes) / frames << " },\n"
+        << "  \"turns\": " << result.turns << "\n"
+        << "}\n";
+}
+
+// One row per run, appended so a file collects a history of runs
+static void WriteCsv(std::ofstream& out, bool header, const AppOptions& options, const BenchmarkResult& result, const std::vector<double>& sorted)
+{
+    int frames = (int)result.frameTimes.size();
+    double total = 0.0;
+    for (double time : result.frameTimes)
+        total += time;
+
+    if (header)
+    {
+        out << "renderer,cube_size,width,height,frames,vsync,scramble,turn_rate,seed,"
+            << "frame_ms_mean,frame_ms_p50,frame_ms_p90,frame_ms_p99,frame_ms_max";
+        for (int phase = 0; phase < PHASE_COUNT; phase++)
+            out << "," << PHASE_NAMES[phase] << "_ms";
+        out << ",draw_calls_mean,draw_calls_max,triangles_mean,binds_mean,redundant_binds_mean,uniforms_mean,upload_bytes_mean,turns\n";
+    }
+
+    std::string renderer = result.renderer;
+    std::replace(renderer.begin(), renderer.end(), '"', '\'');
+    out << "\"" << renderer << "\"," << options.cubeSize << "," << options.width << "," << options.height << ","
+        << frames << "," << (options.vsync ? 1 : 0) << "," << options.scramble << "," << options.turnRate << "," << options.seed << ","
+        << total / frames << "," << Percentile(sorted, 50.0) << "," << Percentile(sorted, 90.0) << ","
+        << Percentile(sorted, 99.0) << "," << sorted.back();
+    for (int phase = 0; phase < PHASE_COUNT; phase++)
+        out << "," << result.phaseTimes[phase] / frames;
+    out << "," << (double)result.render.drawCalls / frames << "," << result.maxDrawCalls << ","
+        << (double)result.render.triangles / frames << "," << (double)result.render.binds / frames << ","
+        << (double)result.render.redundantBinds / frames << "," << (double)result.render.uniformUploads / frames << ","
+        << (double)(result.render.bufferBytes + result.render.textureBytes) / frames << "," << result.turns << "\n";
+}
+
+int RunBenchmark(const AppOptions& options)
+{
+    BenchmarkResult result;
+    if (!RunScenario(options, result))
+        return 1;
+
+    std::vector<double> sorted = result.frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+
+    const std::string& path = options.benchmarkOutput;
+    bool json = EndsWith(path, ".json");
+    bool header = json || !std::ifstream(path) || std::ifstream(path).peek() == std::ifstream::traits_type::eof();
+
+    std::ofstream out(path, json ? std::ios::trunc : std::ios::app);
+    if (!out)
+    {
+        std::cout << "Benchmark: cannot write " << path << std::endl;
+        return 1;
+    }
+    if (json)
+        WriteJson(out, options, result, sorted);
+    else
+        WriteCsv(out, header, options, result, sorted);
+
+    std::cout << "Benchmark: " << sorted.size() << " frames, p50 " << Percentile(sorted, 50.0) << " ms, p99 "
+              << Percentile(sorted, 99.0) << " ms, " << (double)result.render.drawCalls / sorted.size()
+              << " draw calls and " << (double)result.render.redundantBinds / sorted.size()
+              << " redundant binds per frame -> " << path << std::endl;
+    return 0;
+}
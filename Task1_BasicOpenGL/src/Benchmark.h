@@ -0,0 +1,11 @@
+#pragma once
+
+#include "CommandLine.h"
+
+// Renders a scripted scenario offscreen (EGL, like RunHeadless) for
+// options.frames frames: a cube of options.cubeSize scrambled with
+// options.scramble random moves, then random turns queued at options.turnRate
+// per second. Simulated time advances 1/60 s per frame whatever the real frame
+// time, so every run does the same work. Frame time percentiles, time per
+// phase and RenderStats per frame go to options.benchmarkOutput. Returns the exit code.
+int RunBenchmark(const AppOptions& options);
@@ -1,7 +1,9 @@
 #include "Camera.h"
 
+#include <algorithm>
+
 Camera::Camera(int width, int height, glm::vec3 startPos)
-    : m_Width(width), m_Height(height), m_Position(startPos)
+    : m_Position(startPos), m_Width(width), m_Height(height), m_ViewDirty(true), m_ProjectionDirty(true)
 {
     m_WorldUp = glm::vec3(0.0f, 1.0f, 0.0f);
     m_Front = glm::vec3(0.0f, 0.0f, -1.0f);
@@ -11,22 +13,119 @@ Camera::Camera(int width, int height, glm::vec3 startPos)
     UpdateCameraVectors();
 }
 
+Camera Camera::FrameCube(int width, int height, int cubeSize)
+{
+    float distance = 5.0f * std::max(3, cubeSize);
+    Camera camera(width, height, glm::vec3(0.0f, 0.0f, distance));
+
+    // Same planes as the defaults on a 3x3, scaled with the cube so depth
+    // precision and the room for zooming out grow along
+    camera.SetPerspective(45.0f, distance / 150.0f, std::max(100.0f, 4.0f * (distance + cubeSize)));
+    return camera;
+}
+
 void Camera::SetPerspective(float fovDegrees, float nearPlane, float farPlane)
 {
     m_Fov = fovDegrees;
     m_Near = nearPlane;
     m_Far = farPlane;
+    m_ProjectionDirty = true;
+}
+
+void Camera::UpdateSize(int width, int height)
+{
+    // Minimized windows report 0x0, keep the last usable aspect ratio
+    if (width <= 0 || height <= 0)
+        return;
+
+    m_Width = width;
+    m_Height = height;
+    m_ProjectionDirty = true;
+}
+
+void Camera::UpdateMatrices() const
+{
+    if (!m_ViewDirty && !m_ProjectionDirty)
+        return;
+
+    if (m_ViewDirty)
+    {
+        m_View = glm::lookAt(m_Position, m_Position + m_Front, m_Up);
+        m_InverseView = glm::inverse(m_View);
+    }
+
+    if (m_ProjectionDirty)
+    {
+        float aspect = (float)m_Width / (float)m_Height;
+        m_Projection = glm::perspective(glm::radians(m_Fov), aspect, m_Near, m_Far);
+        m_InverseProjection = glm::inverse(m_Projection);
+    }
+
+    m_ViewProjection = m_Projection * m_View;
+    m_InverseViewProjection = m_InverseView * m_InverseProjection;
+    m_ViewDirty = false;
+    m_ProjectionDirty = false;
+}
+
+const glm::mat4& Camera::GetViewMatrix() const
+{
+    UpdateMatrices();
+    return m_View;
+}
+
+const glm::mat4& Camera::GetProjectionMatrix() const
+{
+    UpdateMatrices();
+    return m_Projection;
+}
+
+const glm::mat4& Camera::GetViewProjectionMatrix() const
+{
+    UpdateMatrices();
+    return m_ViewProjection;
 }
 
-glm::mat4 Camera::GetViewMatrix() const
+const glm::mat4& Camera::GetInverseViewMatrix() const
 {
-    return glm::lookAt(m_Position, m_Position + m_Front, m_Up);
+    UpdateMatrices();
+    return m_InverseView;
 }
 
-glm::mat4 Camera::GetProjectionMatrix() const
+const glm::mat4& Camera::GetInverseProjectionMatrix() const
 {
-    float aspect = (float)m_Width / (float)m_Height;
-    return glm::perspective(glm::radians(m_Fov), aspect, m_Near, m_Far);
+    UpdateMatrices();
+    return m_InverseProjection;
+}
+
+const glm::mat4& Camera::GetInverseViewProjectionMatrix() const
+{
+    UpdateMatrices();
+    return m_InverseViewProjection;
+}
+
+glm::vec3 Camera::Unproject(float screenX, float screenY, float depth) const
+{
+    // OpenGL Y is inverted (0 at bottom), screen Y is 0 at top
+    glm::vec4 ndc(
+        2.0f * screenX / (float)m_Width - 1.0f,
+        2.0f * ((float)m_Height - screenY) / (float)m_Height - 1.0f,
+        2.0f * depth - 1.0f,
+        1.0f);
+
+    glm::vec4 world = GetInverseViewProjectionMatrix() * ndc;
+    return glm::vec3(world) / world.w;
+}
+
+void Camera::GetRay(float screenX, float screenY, glm::vec3& origin, glm::vec3& direction) const
+{
+    origin = Unproject(screenX, screenY, 0.0f);
+    direction = glm::normalize(Unproject(screenX, screenY, 1.0f) - origin);
+}
+
+float Camera::GetDepth(const glm::vec3& worldPos) const
+{
+    glm::vec4 clip = GetViewProjectionMatrix() * glm::vec4(worldPos, 1.0f);
+    return (clip.z / clip.w) * 0.5f + 0.5f;
 }
 
 void Camera::Pan(float xOffset, float yOffset)
@@ -34,12 +133,14 @@ void Camera::Pan(float xOffset, float yOffset)
     float speed = 0.05f;
     m_Position -= m_Right * xOffset * speed;
     m_Position -= m_Up * yOffset * speed;
+    m_ViewDirty = true;
 }
 
 void Camera::Zoom(float yOffset)
 {
     float speed = 1.0f;
     m_Position += m_Front * yOffset * speed;
+    m_ViewDirty = true;
 }
 
 void Camera::UpdateCameraVectors()
@@ -48,4 +149,5 @@ void Camera::UpdateCameraVectors()
     m_Front = glm::vec3(0.0f, 0.0f, -1.0f);
     m_Right = glm::normalize(glm::cross(m_Front, m_WorldUp));
     m_Up    = glm::normalize(glm::cross(m_Right, m_Front));
-}
\ No newline at end of file
+    m_ViewDirty = true;
+}
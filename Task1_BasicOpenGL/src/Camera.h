@@ -20,12 +20,36 @@ private:
     int m_Width;
     int m_Height;
 
+    // Cached matrices, rebuilt lazily after Pan/Zoom/UpdateSize/SetPerspective
+    mutable glm::mat4 m_View;
+    mutable glm::mat4 m_InverseView;
+    mutable glm::mat4 m_Projection;
+    mutable glm::mat4 m_InverseProjection;
+    mutable glm::mat4 m_ViewProjection;
+    mutable glm::mat4 m_InverseViewProjection;
+    mutable bool m_ViewDirty;
+    mutable bool m_ProjectionDirty;
+
 public:
     Camera(int width, int height, glm::vec3 startPos);
+    // Looks at an N x N cube from the front, backed off so all of it shows,
+    // with clip planes that keep the whole cube (and zooming out) in range
+    static Camera FrameCube(int width, int height, int cubeSize);
 
     void SetPerspective(float fovDegrees, float nearPlane, float farPlane);
-    glm::mat4 GetViewMatrix() const;
-    glm::mat4 GetProjectionMatrix() const;
+    const glm::mat4& GetViewMatrix() const;
+    const glm::mat4& GetProjectionMatrix() const;
+    const glm::mat4& GetViewProjectionMatrix() const;
+    const glm::mat4& GetInverseViewMatrix() const;
+    const glm::mat4& GetInverseProjectionMatrix() const;
+    const glm::mat4& GetInverseViewProjectionMatrix() const;
+
+    // Screen position (pixels, origin top-left like the cursor) and depth buffer value to world space
+    glm::vec3 Unproject(float screenX, float screenY, float depth) const;
+    // World space ray through a screen position, direction is normalized
+    void GetRay(float screenX, float screenY, glm::vec3& origin, glm::vec3& direction) const;
+    // Depth buffer value of a world position, the inverse of Unproject's depth
+    float GetDepth(const glm::vec3& worldPos) const;
 
     // Camera Transformations
     void Pan(float xOffset, float yOffset);
@@ -33,8 +57,10 @@ public:
     
     // Getters/Setters
     glm::vec3 GetPosition() const { return m_Position; }
-    void UpdateSize(int width, int height) { m_Width = width; m_Height = height; }
+    glm::ivec4 GetViewport() const { return glm::ivec4(0, 0, m_Width, m_Height); }
+    void UpdateSize(int width, int height);
 
 private:
     void UpdateCameraVectors();
-};
\ No newline at end of file
+    void UpdateMatrices() const;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+
+// Time source of the app loop. A FixedClock makes a replay independent of how
+// fast frames actually come.
+class Clock
+{
+    public:
+        virtual ~Clock() = default;
+
+        // Seconds since the clock was created
+        virtual double GetTime() const = 0;
+};
+
+class SystemClock : public Clock
+{
+    private:
+        std::chrono::steady_clock::time_point m_Start;
+    public:
+        SystemClock() : m_Start(std::chrono::steady_clock::now()) {}
+
+        double GetTime() const override
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_Start).count();
+        }
+};
+
+// Moves on by the same step each frame, whatever the real time
+class FixedClock : public Clock
+{
+    private:
+        double m_Time;
+        double m_Step;
+    public:
+        FixedClock(double step) : m_Time(0.0), m_Step(step) {}
+
+        double GetTime() const override { return m_Time; }
+        inline double GetStep() const { return m_Step; }
+        inline void Advance() { m_Time += m_Step; }
+};
@@ -0,0 +1,196 @@
+#include "CommandLine.h"
+
+#include "CubeRenderer.h"
+#include "Simulation.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+// Memory of one cubie while the app runs, about 900 bytes: the cube's own
+// record and slot entry, its draw data in each of the three snapshots, its
+// picture instance on the CPU and in the GPU buffer, and its CubeState entry
+static constexpr size_t CUBIE_FOOTPRINT = sizeof(Cubie) + sizeof(int) + 3 * sizeof(CubieDrawData)
+                                          + 2 * sizeof(CubieInstance) + sizeof(uint32_t) + sizeof(uint8_t);
+static constexpr size_t CUBE_MEMORY_BUDGET = (size_t)2 << 30;
+
+static constexpr int GetMaxCubeSize()
+{
+    int size = 1;
+    while (size < MAX_STATE_CUBE_SIZE && (size_t)(size + 1) * (size + 1) * (size + 1) * CUBIE_FOOTPRINT <= CUBE_MEMORY_BUDGET)
+        size++;
+    return size;
+}
+
+const int MAX_CUBE_SIZE = GetMaxCubeSize();
+
+// Default upper limit of integer flags (sizes in pixels and counts)
+static const int MAX_INT_VALUE = 16384;
+// About 4.6 hours at 60 frames per second, 8 MB of frame times
+static const int MAX_BENCHMARK_FRAMES = 1000000;
+// Benchmark turns queued per second, far more than the queue can animate; the
+// turn count over MAX_BENCHMARK_FRAMES stays well within an int
+static const double MAX_TURN_RATE = 1000.0;
+// Replay speed-up and trace length in seconds (the rings hold a few seconds anyway)
+static const double MAX_REPLAY_SPEED = 1000.0;
+static const double MAX_TRACE_SECONDS = 3600.0;
+
+// Integer argument of a flag within [minValue, maxValue], false if it is missing or malformed
+static bool ReadInt(int argc, char** argv, int& i, int minValue, int maxValue, int& value)
+{
+    if (i + 1 >= argc)
+    {
+        std::cout << argv[i] << " expects a value" << std::endl;
+        return false;
+    }
+
+    char* end = nullptr;
+    long parsed = std::strtol(argv[++i], &end, 10);
+    if (*end != '\0' || parsed < minValue || parsed > maxValue)
+    {
+        std::cout << "Invalid value for " << argv[i - 1] << ": " << argv[i] << std::endl;
+        return false;
+    }
+
+    value = (int)parsed;
+    return true;
+}
+
+// Finite number argument of a flag within [0, maxValue]
+static bool ReadDouble(int argc, char** argv, int& i, double maxValue, double& value)
+{
+    if (i + 1 >= argc)
+    {
+        std::cout << argv[i] << " expects a value" << std::endl;
+        return false;
+    }
+
+    char* end = nullptr;
+    double parsed = std::strtod(argv[++i], &end);
+    if (*end != '\0' || !std::isfinite(parsed) || parsed < 0.0 || parsed > maxValue)
+    {
+        std::cout << "Invalid value for " << argv[i - 1] << ": " << argv[i] << std::endl;
+        return false;
+    }
+
+    value = parsed;
+    return true;
+}
+
+static bool ReadString(int argc, char** argv, int& i, std::string& value)
+{
+    if (i + 1 >= argc)
+    {
+        std::cout << argv[i] << " expects a value" << std::endl;
+        return false;
+    }
+
+    value = argv[++i];
+    return true;
+}
+
+bool ParseCommandLine(int argc, char** argv, AppOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        bool ok = true;
+
+        if (std::strcmp(arg, "--size") == 0)            ok = ReadInt(argc, argv, i, 1, MAX_CUBE_SIZE, options.cubeSize);
+        else if (std::strcmp(arg, "--headless") == 0)   ok = ReadString(argc, argv, i, options.headlessInput);
+        else if (std::strcmp(arg, "--out") == 0)        ok = ReadString(argc, argv, i, options.outputDir);
+        else if (std::strcmp(arg, "--width") == 0)      ok = ReadInt(argc, argv, i, 1, MAX_INT_VALUE, options.width);
+        else if (std::strcmp(arg, "--height") == 0)     ok = ReadInt(argc, argv, i, 1, MAX_INT_VALUE, options.height);
+        else if (std::strcmp(arg, "--software") == 0)   options.software = true;
+        else if (std::strcmp(arg, "--states-out") == 0) ok = ReadString(argc, argv, i, options.statesOutput);
+        else if (std::strcmp(arg, "--picture") == 0)    ok = ReadString(argc, argv, i, options.picture);
+        else if (std::strcmp(arg, "--play") == 0)       ok = ReadString(argc, argv, i, options.playInput);
+        else if (std::strcmp(arg, "--continuous") == 0) options.continuous = true;
+        else if (std::strcmp(arg, "--record") == 0)     ok = ReadString(argc, argv, i, options.recordInput);
+        else if (std::strcmp(arg, "--replay") == 0)     ok = ReadString(argc, argv, i, options.replayInput);
+        else if (std::strcmp(arg, "--replay-speed") == 0) ok = ReadDouble(argc, argv, i, MAX_REPLAY_SPEED, options.replaySpeed);
+        else if (std::strcmp(arg, "--benchmark") == 0)  ok = ReadString(argc, argv, i, options.benchmarkOutput);
+        else if (std::strcmp(arg, "--frames") == 0)     ok = ReadInt(argc, argv, i, 1, MAX_BENCHMARK_FRAMES, options.frames);
+        else if (std::strcmp(arg, "--vsync") == 0)      options.vsync = true;
+        else if (std::strcmp(arg, "--scramble") == 0)   ok = ReadInt(argc, argv, i, 0, MAX_INT_VALUE, options.scramble);
+        else if (std::strcmp(arg, "--turn-rate") == 0)  ok = ReadDouble(argc, argv, i, MAX_TURN_RATE, options.turnRate);
+        else if (std::strcmp(arg, "--seed") == 0)       ok = ReadInt(argc, argv, i, 0, std::numeric_limits<int>::max(), options.seed);
+        else if (std::strcmp(arg, "--overlay") == 0)    options.overlay = true;
+        else if (std::strcmp(arg, "--trace") == 0)      ok = ReadString(argc, argv, i, options.tracePath);
+        else if (std::strcmp(arg, "--trace-seconds") == 0) ok = ReadDouble(argc, argv, i, MAX_TRACE_SECONDS, options.traceSeconds);
+        else if (std::strcmp(arg, "--capture-out") == 0) ok = ReadString(argc, argv, i, options.captureOutput);
+        else if (std::strcmp(arg, "--capture-format") == 0)
+        {
+            std::string format;
+            ok = ReadString(argc, argv, i, format);
+            if (ok && !FrameCapture::ParseFormat(format, options.captureFormat))
+            {
+                std::cout << "Unknown capture format: " << format << " (png, y4m or raw)" << std::endl;
+                ok = false;
+            }
+        }
+        else if (std::strcmp(arg, "--gl-debug") == 0)
+        {
+            std::string level;
+            ok = ReadString(argc, argv, i, level);
+            if (ok && !ParseGLDebugLevel(level, options.glDebug))
+            {
+                std::cout << "Unknown debug level: " << level << " (off, high, medium, low or all)" << std::endl;
+                ok = false;
+            }
+        }
+        else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) options.showHelp = true;
+        else
+        {
+            std::cout << "Unknown option: " << arg << std::endl;
+            ok = false;
+        }
+
+        if (!ok)
+            return false;
+    }
+
+    int defaultSize = options.headlessInput.empty() ? 800 : 256;
+    if (options.width == 0)
+        options.width = defaultSize;
+    if (options.height == 0)
+        options.height = defaultSize;
+    return true;
+}
+
+void PrintUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --size <n>          Cube size (default 3, up to " << MAX_CUBE_SIZE << ")\n"
+              << "  --headless <file>   Render one image per line of <file> without a window: a scramble\n"
+              << "                      such as \"R U R' U'\" or a facelet string (lines starting with #\n"
+              << "                      are skipped), or one per state of a binary state file\n"
+              << "  --out <dir>         Output directory for headless images (default thumbnails)\n"
+              << "  --width <px>        Window, headless image or benchmark width (default 800, 256 headless)\n"
+              << "  --height <px>       Window, headless image or benchmark height (default 800, 256 headless)\n"
+              << "  --software          Render headless images on the CPU (no GL needed)\n"
+              << "  --states-out <file> Also save the headless states to a binary state file\n"
+              << "  --picture <path>    Picture cube image, or a directory with U/D/F/B/R/L.png (X key)\n"
+              << "  --play <file>       Animate the moves in <file> (notation or a binary move stream)\n"
+              << "  --continuous        Redraw every frame, also while nothing changes\n"
+              << "  --record <file>     Log keyboard, mouse and window input to <file>\n"
+              << "  --replay <file>     Play back an input log instead of live input, then exit\n"
+              << "  --replay-speed <x>  Replay speed, 1 = as recorded (default), 0 = as fast as possible\n"
+              << "  --benchmark <file>  Render a scripted scenario offscreen and write frame times to\n"
+              << "                      <file> (.json, otherwise CSV), then exit\n"
+              << "  --frames <n>        Benchmark length in frames (default 600)\n"
+              << "  --vsync             Benchmark: wait for a simulated 60 Hz display after each frame\n"
+              << "  --scramble <n>      Benchmark: random moves applied before the first frame (default 0)\n"
+              << "  --turn-rate <x>     Benchmark: random turns queued per second (default 4, up to 1000)\n"
+              << "  --seed <n>          Benchmark: seed of the random moves (default 1)\n"
+              << "  --overlay           Show the performance overlay from the start (F3 key)\n"
+              << "  --trace <file>      Write a Chrome trace of the last seconds at exit (and on F9)\n"
+              << "  --trace-seconds <s> Length of the trace (default 5)\n"
+              << "  --capture-format <f> Format of the C key recording: png (default), y4m or raw\n"
+              << "  --capture-out <path> Directory (png) or file (y4m, raw) to record into\n"
+              << "  --gl-debug <level>  Print OpenGL debug messages from a debug context: high, medium,\n"
+              << "                      low or all (default off)\n"
+              << "  --help              Show this message\n";
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "FrameCapture.h"
+
+#include <string>
+
+// Biggest cube the app builds (--size, state files): as many cubies as fit in
+// 2 GB at what each one takes (see CommandLine.cpp), 134x134
+extern const int MAX_CUBE_SIZE;
+
+// Settings taken from argv, shared by the interactive and headless paths
+struct AppOptions
+{
+    int cubeSize = 3;
+
+    // Window, headless image or benchmark size; 0 until parsed, then the
+    // default for the mode (256x256 thumbnails, 800x800 otherwise)
+    int width = 0;
+    int height = 0;
+
+    // Headless batch rendering, enabled when an input file is given
+    std::string headlessInput;
+    std::string outputDir = "thumbnails";
+    bool software = false; // CPU rasterizer instead of an EGL context
+    std::string statesOutput; // also save the batch as a binary state file
+
+    // Picture cube (X key): an image used on every face, or a directory
+    // with U.png, D.png, F.png, B.png, R.png and L.png
+    std::string picture;
+
+    // Moves to play back at startup: notation text or a binary move stream
+    std::string playInput;
+
+    // The window is only redrawn when something changed unless this is set
+    bool continuous = false;
+
+    // Input log: written from live input, or played back in its place with a
+    // fixed clock so every replay ends the same way
+    std::string recordInput;
+    std::string replayInput;
+    double replaySpeed = 1.0; // 0 = as fast as possible
+
+    // Benchmark: a scripted scenario rendered offscreen, with the report
+    // written to benchmarkOutput (.json, anything else is CSV)
+    std::string benchmarkOutput;
+    int frames = 600;
+    bool vsync = false;     // wait for a simulated 60 Hz display after each frame
+    int scramble = 0;       // random moves applied before the first frame
+    double turnRate = 4.0;  // random turns queued per second of the scenario
+    int seed = 1;
+
+    // Performance overlay shown from the start (F3 key)
+    bool overlay = false;
+
+    // CPU profiler trace (F9 key, or at exit when a path is given)
+    std::string tracePath; // empty = trace.json on F9
+    double traceSeconds = 5.0;
+
+    // KHR_debug messages from a debug context, at this severity and above
+    GLDebugLevel glDebug = GLDebugLevel::Off;
+
+    // Interactive capture (C key)
+    CaptureFormat captureFormat = CaptureFormat::Png;
+    std::string captureOutput; // empty = FrameCapture::GetDefaultPath
+
+    bool showHelp = false;
+};
+
+// Returns false (after printing why) on unknown flags or bad values
+bool ParseCommandLine(int argc, char** argv, AppOptions& options);
+void PrintUsage(const char* program);
@@ -0,0 +1,348 @@
+#include "CubeFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+    #include <fstream>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+static const char MAGIC[4] = { 'R', 'C', 'U', 'B' };
+static const uint16_t VERSION = 2;
+static const size_t HEADER_SIZE = 32;
+
+// Fields are copied as they are, every platform we build for is little-endian
+static void WriteHeader(std::FILE* file, CubeFileKind kind, int cubeSize, uint32_t count,
+                        uint32_t checkpointInterval, uint64_t indexOffset)
+{
+    unsigned char header[HEADER_SIZE] = {};
+    std::memcpy(header, MAGIC, 4);
+    std::memcpy(header + 4, &VERSION, 2);
+    uint16_t size = (uint16_t)cubeSize;
+    header[6] = (unsigned char)kind;
+    std::memcpy(header + 8, &count, 4);
+    std::memcpy(header + 12, &checkpointInterval, 4);
+    std::memcpy(header + 16, &indexOffset, 8);
+    std::memcpy(header + 24, &size, 2);
+
+    std::fseek(file, 0, SEEK_SET);
+    std::fwrite(header, 1, HEADER_SIZE, file);
+}
+
+static bool IsValidCubeSize(int cubeSize)
+{
+    return cubeSize >= 1 && cubeSize <= MAX_STATE_CUBE_SIZE;
+}
+
+static int EncodeMove(const Move& move, unsigned char* out)
+{
+    int turns = ((move.quarterTurns % 4) + 4) % 4;
+    uint32_t value = 1 + (uint32_t)((move.layer * 3 + move.axis) * 3 + turns - 1);
+
+    int length = 0;
+    do
+    {
+        out[length] = (unsigned char)(value & 0x7F);
+        value >>= 7;
+        if (value)
+            out[length] |= 0x80;
+        length++;
+    } while (value);
+    return length;
+}
+
+StateFileWriter::StateFileWriter(const std::string& filepath, int cubeSize)
+    : m_File(nullptr), m_CubeSize(cubeSize), m_Count(0)
+{
+    if (!IsValidCubeSize(cubeSize))
+        return;
+
+    m_Record.resize(GetPackedStateSize(cubeSize));
+    m_File = std::fopen(filepath.c_str(), "wb");
+
+    // Rewritten with the count on Close
+    if (m_File)
+        WriteHeader(m_File, CubeFileKind::States, m_CubeSize, 0, 0, 0);
+}
+
+StateFileWriter::~StateFileWriter()
+{
+    Close();
+}
+
+void StateFileWriter::Write(const CubeState& state)
+{
+    if (!m_File || state.size != m_CubeSize)
+        return;
+
+    PackState(state, m_Record.data());
+    std::fwrite(m_Record.data(), 1, m_Record.size(), m_File);
+    m_Count++;
+}
+
+bool StateFileWriter::Close()
+{
+    if (!m_File)
+        return false;
+
+    WriteHeader(m_File, CubeFileKind::States, m_CubeSize, m_Count, 0, 0);
+    bool ok = !std::ferror(m_File);
+    ok = std::fclose(m_File) == 0 && ok;
+    m_File = nullptr;
+    return ok;
+}
+
+MoveStreamWriter::MoveStreamWriter(const std::string& filepath, const CubeState& start, uint32_t checkpointInterval)
+    : m_File(nullptr), m_State(start), m_Offset(HEADER_SIZE), m_Count(0),
+      m_CheckpointInterval(checkpointInterval > 0 ? checkpointInterval : 1)
+{
+    if (!IsValidCubeSize(start.size))
+        return;
+
+    m_Record.resize(1 + GetPackedStateSize(start.size));
+    m_File = std::fopen(filepath.c_str(), "wb");
+    if (!m_File)
+        return;
+
+    WriteHeader(m_File, CubeFileKind::Moves, m_State.size, 0, m_CheckpointInterval, 0);
+    WriteCheckpoint();
+}
+
+MoveStreamWriter::~MoveStreamWriter()
+{
+    Close();
+}
+
+void MoveStreamWriter::WriteCheckpoint()
+{
+    m_Checkpoints.push_back(m_Offset);
+    m_Record[0] = 0;
+    PackState(m_State, m_Record.data() + 1);
+    std::fwrite(m_Record.data(), 1, m_Record.size(), m_File);
+    m_Offset += m_Record.size();
+}
+
+void MoveStreamWriter::Write(const Move& move)
+{
+    if (!m_File || move.quarterTurns % 4 == 0)
+        return;
+
+    unsigned char bytes[5];
+    int length = EncodeMove(move, bytes);
+    std::fwrite(bytes, 1, length, m_File);
+    m_Offset += length;
+    m_State.ApplyMove(move);
+
+    if (++m_Count % m_CheckpointInterval == 0)
+        WriteCheckpoint();
+}
+
+bool MoveStreamWriter::Close()
+{
+    if (!m_File)
+        return false;
+
+    std::fwrite(m_Checkpoints.data(), sizeof(uint64_t), m_Checkpoints.size(), m_File);
+    WriteHeader(m_File, CubeFileKind::Moves, m_State.size, m_Count, m_CheckpointInterval, m_Offset);
+
+    bool ok = !std::ferror(m_File);
+    ok = std::fclose(m_File) == 0 && ok;
+    m_File = nullptr;
+    return ok;
+}
+
+bool MoveCursor::Next(Move& move)
+{
+    // Checkpoints are only there for Seek
+    while (m_Data < m_End && *m_Data == 0)
+        m_Data += 1 + m_StateSize;
+
+    uint32_t value = 0;
+    int shift = 0;
+    while (true)
+    {
+        if (m_Data >= m_End || shift > 28)
+            return false;
+        unsigned char byte = *m_Data++;
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+        if (!(byte & 0x80))
+            break;
+    }
+
+    value--;
+    move.layer = (int)(value / 9);
+    move.axis = (int)(value / 3 % 3);
+    move.quarterTurns = (int)(value % 3) == 2 ? -1 : (int)(value % 3) + 1;
+    if (move.layer >= m_CubeSize)
+        return false;
+
+    m_Index++;
+    return true;
+}
+
+CubeFileReader::CubeFileReader(const std::string& filepath)
+    : m_Data(nullptr), m_Size(0), m_Mapping(nullptr), m_Kind(CubeFileKind::States), m_CubeSize(0), m_Count(0),
+      m_CheckpointInterval(0), m_StateSize(0), m_CheckpointIndex(nullptr), m_CheckpointCount(0)
+{
+    if (!Open(filepath) || !ReadHeader())
+        Unmap();
+}
+
+CubeFileReader::~CubeFileReader()
+{
+    Unmap();
+}
+
+void CubeFileReader::Unmap()
+{
+#if !defined(_WIN32)
+    if (m_Mapping)
+        munmap(m_Mapping, m_Size);
+#endif
+    m_Mapping = nullptr;
+    m_Buffer.clear();
+    m_Data = nullptr;
+}
+
+bool CubeFileReader::Open(const std::string& filepath)
+{
+#if defined(_WIN32)
+    std::ifstream stream(filepath, std::ios::binary);
+    if (!stream)
+    {
+        m_Error = "cannot open file";
+        return false;
+    }
+    m_Buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    m_Data = m_Buffer.data();
+    m_Size = m_Buffer.size();
+#else
+    int fd = open(filepath.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        m_Error = "cannot open file";
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+
+    m_Size = (size_t)info.st_size;
+    if (m_Size >= HEADER_SIZE)
+    {
+        void* mapping = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+            m_Mapping = mapping;
+            m_Data = (const unsigned char*)mapping;
+
+            // Records are mostly read front to back
+            madvise(mapping, m_Size, MADV_SEQUENTIAL);
+        }
+    }
+    close(fd);
+#endif
+
+    if (!m_Data || m_Size < HEADER_SIZE || std::memcmp(m_Data, MAGIC, 4) != 0)
+    {
+        m_Error = "not a cube file";
+        return false;
+    }
+    return true;
+}
+
+bool CubeFileReader::ReadHeader()
+{
+    uint16_t version;
+    uint64_t indexOffset;
+    std::memcpy(&version, m_Data + 4, 2);
+    m_Kind = (CubeFileKind)m_Data[6];
+    std::memcpy(&m_Count, m_Data + 8, 4);
+    std::memcpy(&m_CheckpointInterval, m_Data + 12, 4);
+    std::memcpy(&indexOffset, m_Data + 16, 8);
+
+    // Version 1 only differs in where the size is
+    uint16_t size = m_Data[7];
+    if (version == VERSION)
+        std::memcpy(&size, m_Data + 24, 2);
+    m_CubeSize = size;
+    m_StateSize = IsValidCubeSize(m_CubeSize) ? GetPackedStateSize(m_CubeSize) : 0;
+
+    if (version != VERSION && version != 1)
+        m_Error = "unsupported version " + std::to_string(version);
+    else if (!IsValidCubeSize(m_CubeSize))
+        m_Error = "bad cube size";
+    else if (m_Kind == CubeFileKind::States)
+    {
+        if ((m_Size - HEADER_SIZE) / m_StateSize < m_Count)
+            m_Error = "truncated file";
+    }
+    else if (m_Kind == CubeFileKind::Moves)
+    {
+        m_CheckpointIndex = m_Data + indexOffset;
+        m_CheckpointCount = indexOffset < m_Size ? (m_Size - indexOffset) / sizeof(uint64_t) : 0;
+        if (indexOffset < HEADER_SIZE || m_CheckpointInterval == 0 || m_CheckpointCount == 0)
+            m_Error = "bad checkpoint index";
+    }
+    else
+        m_Error = "unknown file kind";
+
+    return m_Error.empty();
+}
+
+const unsigned char* CubeFileReader::GetStateRecord(uint32_t index) const
+{
+    if (m_Kind != CubeFileKind::States || index >= m_Count)
+        return nullptr;
+    return m_Data + HEADER_SIZE + (size_t)index * m_StateSize;
+}
+
+bool CubeFileReader::ReadState(uint32_t index, CubeState& state) const
+{
+    const unsigned char* record = GetStateRecord(index);
+    return record && UnpackState(record, m_CubeSize, state);
+}
+
+bool CubeFileReader::Seek(uint32_t index, CubeState& state, MoveCursor& cursor) const
+{
+    if (m_Kind != CubeFileKind::Moves || index > m_Count)
+        return false;
+
+    size_t checkpoint = std::min<size_t>(index / m_CheckpointInterval, m_CheckpointCount - 1);
+    uint64_t offset;
+    std::memcpy(&offset, m_CheckpointIndex + checkpoint * sizeof(uint64_t), sizeof(offset));
+    if (offset + 1 + m_StateSize > m_Size || m_Data[offset] != 0 || !UnpackState(m_Data + offset + 1, m_CubeSize, state))
+        return false;
+
+    cursor.m_Data = m_Data + offset + 1 + m_StateSize;
+    cursor.m_End = m_CheckpointIndex;
+    cursor.m_CubeSize = m_CubeSize;
+    cursor.m_StateSize = m_StateSize;
+    cursor.m_Index = (uint32_t)(checkpoint * m_CheckpointInterval);
+
+    Move move;
+    while (cursor.m_Index < index)
+    {
+        if (!cursor.Next(move))
+            return false;
+        state.ApplyMove(move);
+    }
+    return true;
+}
+
+bool IsCubeFile(const std::string& filepath)
+{
+    char magic[4] = {};
+    std::FILE* file = std::fopen(filepath.c_str(), "rb");
+    if (!file)
+        return false;
+    bool match = std::fread(magic, 1, 4, file) == 4 && std::memcmp(magic, MAGIC, 4) == 0;
+    std::fclose(file);
+    return match;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "CubeState.h"
+#include "Move.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Binary files for many cube states or long move logs. Layout (little-endian):
+//
+//   header   32 bytes: "RCUB", u16 version, u8 kind, u8 reserved, u32 count,
+//            u32 checkpoint interval, u64 checkpoint index offset, u16 cube size,
+//            6 bytes reserved (version 1 had a u8 cube size in the reserved byte)
+//   States   count records of GetPackedStateSize(size) bytes, so record i is at
+//            32 + i * size and can be read without touching the others
+//   Moves    the start state as a checkpoint, then every move as a varint, with
+//            another checkpoint after each interval moves. A checkpoint is a 0
+//            byte and a packed state. The file ends with the u64 offsets of all
+//            checkpoints, which lets a reader start near any move.
+//
+// A move is stored as 1 + (layer * 3 + axis) * 3 + turn, turn 0 / 1 / 2 for a
+// quarter, a half and a counter quarter turn: one byte for any 3x3 move.
+//
+// Sizes go up to MAX_STATE_CUBE_SIZE. The writers refuse anything larger (or
+// smaller than 1) and stay invalid.
+enum class CubeFileKind : uint8_t
+{
+    States = 1,
+    Moves = 2
+};
+
+class StateFileWriter
+{
+    private:
+        std::FILE* m_File;
+        int m_CubeSize;
+        uint32_t m_Count;
+        std::vector<unsigned char> m_Record;
+    public:
+        StateFileWriter(const std::string& filepath, int cubeSize);
+        ~StateFileWriter();
+
+        StateFileWriter(const StateFileWriter&) = delete;
+        StateFileWriter& operator=(const StateFileWriter&) = delete;
+
+        // state.size has to match the file
+        void Write(const CubeState& state);
+        // Fills in the count, false if anything failed to write
+        bool Close();
+
+        inline bool IsValid() const { return m_File != nullptr; }
+        inline uint32_t GetCount() const { return m_Count; }
+};
+
+class MoveStreamWriter
+{
+    private:
+        std::FILE* m_File;
+        CubeState m_State; // tracked for the checkpoints
+        uint64_t m_Offset;
+        uint32_t m_Count;
+        uint32_t m_CheckpointInterval;
+        std::vector<uint64_t> m_Checkpoints;
+        std::vector<unsigned char> m_Record;
+
+        void WriteCheckpoint();
+    public:
+        MoveStreamWriter(const std::string& filepath, const CubeState& start, uint32_t checkpointInterval = 1024);
+        ~MoveStreamWriter();
+
+        MoveStreamWriter(const MoveStreamWriter&) = delete;
+        MoveStreamWriter& operator=(const MoveStreamWriter&) = delete;
+
+        // Moves that turn nothing (quarterTurns % 4 == 0) are skipped
+        void Write(const Move& move);
+        bool Close();
+
+        inline bool IsValid() const { return m_File != nullptr; }
+        inline uint32_t GetCount() const { return m_Count; }
+};
+
+// Read position in a move stream, handed out by CubeFileReader
+class MoveCursor
+{
+    private:
+        friend class CubeFileReader;
+        const unsigned char* m_Data = nullptr;
+        const unsigned char* m_End = nullptr;
+        int m_CubeSize = 0;
+        size_t m_StateSize = 0;
+        uint32_t m_Index = 0;
+    public:
+        // False at the end of the stream or on corrupt data
+        bool Next(Move& move);
+        // Number of moves read so far (counting from the start of the stream)
+        inline uint32_t GetIndex() const { return m_Index; }
+};
+
+// Maps a whole file read-only (mmap, or a plain read on Windows), records are
+// decoded straight from the mapping
+class CubeFileReader
+{
+    private:
+        const unsigned char* m_Data;
+        size_t m_Size;
+        void* m_Mapping;
+        std::vector<unsigned char> m_Buffer; // Windows only
+        std::string m_Error;
+
+        CubeFileKind m_Kind;
+        int m_CubeSize;
+        uint32_t m_Count;
+        uint32_t m_CheckpointInterval;
+        size_t m_StateSize;
+        const unsigned char* m_CheckpointIndex;
+        size_t m_CheckpointCount;
+
+        bool Open(const std::string& filepath);
+        bool ReadHeader();
+        void Unmap();
+    public:
+        CubeFileReader(const std::string& filepath);
+        ~CubeFileReader();
+
+        CubeFileReader(const CubeFileReader&) = delete;
+        CubeFileReader& operator=(const CubeFileReader&) = delete;
+
+        inline bool IsValid() const { return m_Data != nullptr; }
+        inline const std::string& GetError() const { return m_Error; }
+        inline CubeFileKind GetKind() const { return m_Kind; }
+        inline int GetCubeSize() const { return m_CubeSize; }
+        // States in a state file, moves in a move stream
+        inline uint32_t GetCount() const { return m_Count; }
+
+        // State files: packed record i (GetPackedStateSize bytes) inside the mapping
+        const unsigned char* GetStateRecord(uint32_t index) const;
+        bool ReadState(uint32_t index, CubeState& state) const;
+
+        // Move streams: state before move `index` and a cursor that reads on from it,
+        // replaying at most one checkpoint interval
+        bool Seek(uint32_t index, CubeState& state, MoveCursor& cursor) const;
+};
+
+// Sniffs the magic, for inputs that may be text or binary
+bool IsCubeFile(const std::string& filepath);
@@ -1,48 +1,61 @@
 #include "CubeMesh.h"
 #include "Debugger.h"
+#include "RenderStats.h"
 
 #include <glad/glad.h>
 
-// 24 vertices (4 per face), each vertex: pos(3), color(3), uv(2) = 8 floats
-static float cubeVertices[] = {
+// Half-float bit patterns used by the UVs
+static const unsigned short H0 = 0x0000; // 0.0
+static const unsigned short H1 = 0x3C00; // 1.0
+
+// Normalized byte for +-1.0
+static const signed char P = 127;
+static const signed char N = -127;
+
+#define FACE(f) (unsigned char)Face::f
+
+// 24 vertices (4 per face), 8 bytes each: pos(3 x snorm8), face(uint8), uv(2 x half)
+static const CubeVertex cubeVertices[] = {
     // +Z (front)
-    -1.f,-1.f, 1.f,   1,1,1,   0,0,
-     1.f,-1.f, 1.f,   1,1,1,   1,0,
-     1.f, 1.f, 1.f,   1,1,1,   1,1,
-    -1.f, 1.f, 1.f,   1,1,1,   0,1,
+    { { N, N, P }, FACE(PosZ), { { H0 }, { H0 } } },
+    { { P, N, P }, FACE(PosZ), { { H1 }, { H0 } } },
+    { { P, P, P }, FACE(PosZ), { { H1 }, { H1 } } },
+    { { N, P, P }, FACE(PosZ), { { H0 }, { H1 } } },
 
     // -Z (back)
-     1.f,-1.f,-1.f,   1,1,1,   0,0,
-    -1.f,-1.f,-1.f,   1,1,1,   1,0,
-    -1.f, 1.f,-1.f,   1,1,1,   1,1,
-     1.f, 1.f,-1.f,   1,1,1,   0,1,
+    { { P, N, N }, FACE(NegZ), { { H0 }, { H0 } } },
+    { { N, N, N }, FACE(NegZ), { { H1 }, { H0 } } },
+    { { N, P, N }, FACE(NegZ), { { H1 }, { H1 } } },
+    { { P, P, N }, FACE(NegZ), { { H0 }, { H1 } } },
 
     // +X (right)
-     1.f,-1.f, 1.f,   1,1,1,   0,0,
-     1.f,-1.f,-1.f,   1,1,1,   1,0,
-     1.f, 1.f,-1.f,   1,1,1,   1,1,
-     1.f, 1.f, 1.f,   1,1,1,   0,1,
+    { { P, N, P }, FACE(PosX), { { H0 }, { H0 } } },
+    { { P, N, N }, FACE(PosX), { { H1 }, { H0 } } },
+    { { P, P, N }, FACE(PosX), { { H1 }, { H1 } } },
+    { { P, P, P }, FACE(PosX), { { H0 }, { H1 } } },
 
     // -X (left)
-    -1.f,-1.f,-1.f,   1,1,1,   0,0,
-    -1.f,-1.f, 1.f,   1,1,1,   1,0,
-    -1.f, 1.f, 1.f,   1,1,1,   1,1,
-    -1.f, 1.f,-1.f,   1,1,1,   0,1,
+    { { N, N, N }, FACE(NegX), { { H0 }, { H0 } } },
+    { { N, N, P }, FACE(NegX), { { H1 }, { H0 } } },
+    { { N, P, P }, FACE(NegX), { { H1 }, { H1 } } },
+    { { N, P, N }, FACE(NegX), { { H0 }, { H1 } } },
 
     // +Y (top)
-    -1.f, 1.f, 1.f,   1,1,1,   0,0,
-     1.f, 1.f, 1.f,   1,1,1,   1,0,
-     1.f, 1.f,-1.f,   1,1,1,   1,1,
-    -1.f, 1.f,-1.f,   1,1,1,   0,1,
+    { { N, P, P }, FACE(PosY), { { H0 }, { H0 } } },
+    { { P, P, P }, FACE(PosY), { { H1 }, { H0 } } },
+    { { P, P, N }, FACE(PosY), { { H1 }, { H1 } } },
+    { { N, P, N }, FACE(PosY), { { H0 }, { H1 } } },
 
     // -Y (bottom)
-    -1.f,-1.f,-1.f,   1,1,1,   0,0,
-     1.f,-1.f,-1.f,   1,1,1,   1,0,
-     1.f,-1.f, 1.f,   1,1,1,   1,1,
-    -1.f,-1.f, 1.f,   1,1,1,   0,1,
+    { { N, N, N }, FACE(NegY), { { H0 }, { H0 } } },
+    { { P, N, N }, FACE(NegY), { { H1 }, { H0 } } },
+    { { P, N, P }, FACE(NegY), { { H1 }, { H1 } } },
+    { { N, N, P }, FACE(NegY), { { H0 }, { H1 } } },
 };
 
-static unsigned int cubeIndices[] = {
+#undef FACE
+
+static const unsigned short cubeIndices[] = {
     0,1,2,  2,3,0,        // front
     4,5,6,  6,7,4,        // back
     8,9,10, 10,11,8,      // right
@@ -51,15 +64,17 @@ static unsigned int cubeIndices[] = {
     20,21,22, 22,23,20    // bottom
 };
 
+static_assert(sizeof(CubeVertex) == 8, "CubeVertex must stay tightly packed");
+
 CubeMesh::CubeMesh()
     : m_VAO()
     , m_VBO(cubeVertices, sizeof(cubeVertices))
     , m_EBO(cubeIndices, sizeof(cubeIndices))
 {
     VertexBufferLayout layout;
-    layout.Push<float>(3); // positions
-    layout.Push<float>(3); // colors
-    layout.Push<float>(2); // texCoords
+    layout.Push<signed char>(3);        // positions
+    layout.PushInteger<unsigned char>(1); // face (indexes the sticker colors)
+    layout.Push<HalfFloat>(2);          // texCoords
     m_VAO.AddBuffer(m_VBO, layout);
 }
 
@@ -80,8 +95,31 @@ unsigned int CubeMesh::GetIndexCount() const
     return m_EBO.GetCount();
 }
 
+unsigned int CubeMesh::GetIndexType() const
+{
+    return m_EBO.GetType();
+}
+
+void CubeMesh::AddInstanceBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int firstIndex)
+{
+    m_VAO.AddBuffer(vb, layout, firstIndex, 1);
+}
+
+const CubeVertex* CubeMesh::GetVertexData(unsigned int& count)
+{
+    count = sizeof(cubeVertices) / sizeof(cubeVertices[0]);
+    return cubeVertices;
+}
+
+const unsigned short* CubeMesh::GetIndexData(unsigned int& count)
+{
+    count = sizeof(cubeIndices) / sizeof(cubeIndices[0]);
+    return cubeIndices;
+}
+
 void CubeMesh::Draw() const
 {
     Bind();
-    GLCall(glDrawElements(GL_TRIANGLES, m_EBO.GetCount(), GL_UNSIGNED_INT, nullptr));
+    GLCall(glDrawElements(GL_TRIANGLES, m_EBO.GetCount(), m_EBO.GetType(), nullptr));
+    RenderStats::CountDraw(m_EBO.GetCount());
 }
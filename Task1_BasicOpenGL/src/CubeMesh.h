@@ -4,6 +4,15 @@
 #include "VertexBuffer.h"
 #include "IndexBuffer.h"
 #include "VertexBufferLayout.h"
+#include "Cubie.h"
+
+// Packed cube vertex, positions are +-1 and the face is a Face value
+struct CubeVertex
+{
+    signed char position[3];
+    unsigned char face;
+    HalfFloat texCoord[2];
+};
 
 class CubeMesh
 {
@@ -24,5 +33,12 @@ public:
     void Unbind() const;
 
     void Draw() const;
+    // Per-instance attributes, numbered from firstIndex (the mesh uses 0 - 2)
+    void AddInstanceBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int firstIndex = 3);
     unsigned int GetIndexCount() const;
+    unsigned int GetIndexType() const;
+
+    // The same geometry on the CPU side, e.g. for the software rasterizer
+    static const CubeVertex* GetVertexData(unsigned int& count);
+    static const unsigned short* GetIndexData(unsigned int& count);
 };
@@ -0,0 +1,180 @@
+#include "CubeRenderer.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+
+// Binding point of the FrameData uniform block
+static const unsigned int FRAME_DATA_BINDING = 0;
+
+// Mirrors the std140 FrameData block in basic.shader
+struct FrameData
+{
+    glm::mat4 viewProj;
+    glm::mat4 global;
+};
+
+CubeRenderer::CubeRenderer(int cubeSize)
+    : m_CubeSize(cubeSize), m_Mesh(new CubeMesh()), m_FrameUniforms(new UniformBuffer(sizeof(FrameData), FRAME_DATA_BINDING)),
+      m_InstanceBuffer(nullptr)
+{
+    LoadShaderVariant(m_FlatShader, "");
+    LoadShaderVariant(m_PickingShader, "PICKING");
+}
+
+CubeRenderer::~CubeRenderer()
+{
+    delete m_Mesh;
+    delete m_FrameUniforms;
+    delete m_FlatShader.shader;
+    delete m_TexturedShader.shader;
+    delete m_PickingShader.shader;
+    delete m_PictureShader.shader;
+    delete m_InstanceBuffer;
+}
+
+void CubeRenderer::LoadShaderVariant(CubeShaderVariant& variant, const std::string& define)
+{
+    PROFILE_SCOPE("CubeRenderer::LoadShaderVariant");
+    std::vector<std::string> defines;
+    if (!define.empty())
+        defines.push_back(define);
+
+    variant.shader = new Shader("res/shaders/basic.shader", defines);
+    variant.shader->BindUniformBlock("FrameData", FRAME_DATA_BINDING);
+
+    // The picture variant takes its per-cubie data from the instance buffer
+    if (define == "PICTURE")
+        return;
+
+    variant.model = variant.shader->GetUniformHandle("u_Model");
+    if (define == "PICKING")
+        variant.pickId = variant.shader->GetUniformHandle("u_PickID");
+    else
+        variant.faceColors = variant.shader->GetUniformHandle("u_FaceColors");
+}
+
+void CubeRenderer::SetStickerTexture(const TextureHandle& texture)
+{
+    m_Texture = texture;
+    if (!m_Texture || m_TexturedShader.shader)
+        return;
+
+    LoadShaderVariant(m_TexturedShader, "TEXTURED");
+
+    // The sampler never changes, set it once instead of every frame
+    m_TexturedShader.shader->Bind();
+    m_TexturedShader.shader->SetUniform1i("u_Texture", 0);
+}
+
+void CubeRenderer::SetPicture(const std::shared_ptr<TextureArray>& faces)
+{
+    m_Picture = faces;
+    if (!m_Picture || m_PictureShader.shader)
+        return;
+
+    LoadShaderVariant(m_PictureShader, "PICTURE");
+    m_PictureShader.shader->Bind();
+    m_PictureShader.shader->SetUniform1i("u_Pictures", 0);
+    m_PictureShader.shader->SetUniform1f("u_StickerSize", 1.0f / m_CubeSize);
+
+    static_assert(sizeof(CubieInstance) == 92, "CubieInstance must match the instance layout");
+    size_t cubieCount = (size_t)m_CubeSize * m_CubeSize * m_CubeSize;
+    m_InstanceBuffer = new VertexBuffer((unsigned int)(cubieCount * sizeof(CubieInstance)));
+
+    VertexBufferLayout layout;
+    for (int column = 0; column < 4; column++)
+        layout.Push<float>(4);              // model (a mat4 takes 4 locations)
+    layout.PushInteger<unsigned int>(1);    // flags
+    layout.PushInteger<unsigned int>(4);    // faceRects 0 - 3
+    layout.PushInteger<unsigned int>(2);    // faceRects 4 - 5
+    m_Mesh->AddInstanceBuffer(*m_InstanceBuffer, layout);
+}
+
+void CubeRenderer::SetFrameData(const glm::mat4& viewProj, const glm::mat4& globalModel)
+{
+    PROFILE_SCOPE("CubeRenderer::SetFrameData");
+    FrameData frame;
+    frame.viewProj = viewProj;
+    frame.global = globalModel;
+    // Attached to FRAME_DATA_BINDING since construction
+    m_FrameUniforms->SetData(&frame, sizeof(frame));
+}
+
+void CubeRenderer::Draw(const glm::mat4& viewProj, const glm::mat4& globalModel, const std::vector<CubieDrawData>& draws)
+{
+    PROFILE_SCOPE("CubeRenderer::Draw");
+    SetFrameData(viewProj, globalModel);
+
+    if (m_Picture)
+    {
+        DrawPicture(draws);
+        return;
+    }
+
+    const CubeShaderVariant& variant = m_Texture ? m_TexturedShader : m_FlatShader;
+    variant.shader->Bind();
+    if (m_Texture)
+        m_Texture->Bind(0);
+    m_Mesh->Bind();
+
+    for (const auto& draw : draws)
+    {
+        if (draw.hidden)
+            continue;
+
+        // The global rotation comes from the FrameData block
+        variant.shader->SetUniformMat4f(variant.model, draw.model);
+
+        // Colors are indexed by the face ID baked into the mesh
+        variant.shader->SetUniform4fv(variant.faceColors, draw.faceColors, 6);
+
+        glDrawElements(GL_TRIANGLES, m_Mesh->GetIndexCount(), m_Mesh->GetIndexType(), nullptr);
+        RenderStats::CountDraw(m_Mesh->GetIndexCount());
+    }
+}
+
+void CubeRenderer::DrawPicture(const std::vector<CubieDrawData>& draws)
+{
+    PROFILE_SCOPE("CubeRenderer::DrawPicture");
+    m_Instances.resize(draws.size());
+    for (size_t i = 0; i < draws.size(); i++)
+    {
+        CubieInstance& instance = m_Instances[i];
+        instance.model = draws[i].model;
+        instance.flags = draws[i].highlighted ? 2u : 0u;
+        for (int f = 0; f < 6; f++)
+            instance.faceRects[f] = draws[i].stickerRects[f];
+    }
+    m_InstanceBuffer->SetData(m_Instances.data(), (unsigned int)(m_Instances.size() * sizeof(CubieInstance)));
+
+    // Whole cube, one texture bind and one draw
+    m_PictureShader.shader->Bind();
+    m_Picture->Bind(0);
+    m_Mesh->Bind();
+    GLCall(glDrawElementsInstanced(GL_TRIANGLES, m_Mesh->GetIndexCount(), m_Mesh->GetIndexType(), nullptr,
+                                   (GLsizei)m_Instances.size()));
+    RenderStats::CountDraw(m_Mesh->GetIndexCount(), (unsigned int)m_Instances.size());
+}
+
+void CubeRenderer::DrawPicking(const glm::mat4& viewProj, const glm::mat4& globalModel, const std::vector<CubieDrawData>& draws)
+{
+    PROFILE_SCOPE("CubeRenderer::DrawPicking");
+    SetFrameData(viewProj, globalModel);
+
+    Shader* shader = m_PickingShader.shader;
+    shader->Bind();
+    m_Mesh->Bind();
+
+    for (const auto& draw : draws)
+    {
+        // Inner pieces are out of sight while every cubie is in its slot,
+        // which leaves O(N^2) draws on big cubes
+        if (draw.hidden)
+            continue;
+
+        shader->SetUniformMat4f(m_PickingShader.model, draw.model);
+        shader->SetUniform1ui(m_PickingShader.pickId, (unsigned int)draw.id + 1);
+
+        glDrawElements(GL_TRIANGLES, m_Mesh->GetIndexCount(), m_Mesh->GetIndexType(), nullptr);
+        RenderStats::CountDraw(m_Mesh->GetIndexCount());
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CubeMesh.h"
+#include "RubiksCube.h"
+#include "Shader.h"
+#include "TextureArray.h"
+#include "TextureCache.h"
+#include "UniformBuffer.h"
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+// One compiled variant of basic.shader together with its uniform handles
+struct CubeShaderVariant
+{
+    Shader* shader = nullptr;
+    UniformHandle model;
+    UniformHandle pickId;     // picking variant only
+    UniformHandle faceColors; // sticker colors
+};
+
+// Per-instance data of the PICTURE shader variant, one per cubie
+struct CubieInstance
+{
+    glm::mat4 model;
+    unsigned int flags;        // 2 = highlighted
+    unsigned int faceRects[6]; // corner of each sticker in its face image (unorm16 u, v), by Face
+};
+
+// GL side of a cube: mesh, programs and per-frame buffers. Draws the cubies as
+// given by RubiksCube::GetDrawData, so it never touches the cube itself and can
+// draw a snapshot while the cube keeps changing on another thread.
+class CubeRenderer
+{
+    private:
+        int m_CubeSize;
+        CubeMesh* m_Mesh;
+        TextureHandle m_Texture;
+        UniformBuffer* m_FrameUniforms;
+        std::shared_ptr<TextureArray> m_Picture;
+        VertexBuffer* m_InstanceBuffer; // created with the picture variant
+        std::vector<CubieInstance> m_Instances;
+
+        // Specialized programs, selected per pass
+        CubeShaderVariant m_FlatShader;
+        CubeShaderVariant m_TexturedShader; // compiled on first SetStickerTexture
+        CubeShaderVariant m_PickingShader;
+        CubeShaderVariant m_PictureShader;  // compiled on first SetPicture
+
+        // define is one of the basic.shader variants, "" for the flat one
+        void LoadShaderVariant(CubeShaderVariant& variant, const std::string& define);
+        void SetFrameData(const glm::mat4& viewProj, const glm::mat4& globalModel);
+        void DrawPicture(const std::vector<CubieDrawData>& draws);
+    public:
+        CubeRenderer(int cubeSize);
+        ~CubeRenderer();
+
+        CubeRenderer(const CubeRenderer&) = delete;
+        CubeRenderer& operator=(const CubeRenderer&) = delete;
+
+        void Draw(const glm::mat4& viewProj, const glm::mat4& globalModel, const std::vector<CubieDrawData>& draws);
+        // Into an RG32UI target: (cubie ID + 1, face), 0 = background
+        void DrawPicking(const glm::mat4& viewProj, const glm::mat4& globalModel, const std::vector<CubieDrawData>& draws);
+
+        // Stickers modulated by a texture (e.g. a sticker mask), null for flat colors
+        void SetStickerTexture(const TextureHandle& texture);
+        inline bool HasStickerTexture() const { return m_Texture != nullptr; }
+
+        // Picture cube: one image per face (layer = Face value), drawn in a single
+        // instanced call. Null goes back to colored stickers.
+        void SetPicture(const std::shared_ptr<TextureArray>& faces);
+        inline bool HasPicture() const { return m_Picture != nullptr; }
+};
@@ -0,0 +1,371 @@
+#include "CubeState.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+// Sticker letters and outward normals by Face value (PosY, NegY, NegZ, PosZ, PosX, NegX)
+static const char FACE_LETTERS[6] = { 'U', 'D', 'B', 'F', 'R', 'L' };
+static const glm::ivec3 FACE_NORMALS[6] = {
+    { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, -1 }, { 0, 0, 1 }, { 1, 0, 0 }, { -1, 0, 0 }
+};
+
+// Facelet string face order (U R F D L B) as Face values
+static const int FACELET_FACES[6] = { 0, 4, 3, 1, 5, 2 };
+
+using IntMat3 = glm::mat<3, 3, int>;
+
+// The rotation group, built once by closing the X and Y quarter turns
+struct RotationTables
+{
+    glm::mat3 rotations[24];
+    IntMat3 integer[24];
+    IntMat3 inverse[24]; // world -> cubie frame
+    int product[24][24]; // index of rotations[a] * rotations[b]
+    int quarterTurns[3][4]; // index of 0 - 3 counter-clockwise quarter turns about X, Y, Z
+
+    RotationTables()
+    {
+        glm::mat3 quarterX = Round(glm::mat3(glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), glm::vec3(1, 0, 0))));
+        glm::mat3 quarterY = Round(glm::mat3(glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), glm::vec3(0, 1, 0))));
+
+        int count = 1;
+        rotations[0] = glm::mat3(1.0f);
+        for (int i = 0; i < count; i++)
+        {
+            for (const glm::mat3& turn : { quarterX, quarterY })
+            {
+                glm::mat3 next = turn * rotations[i];
+                if (Find(next, count) < 0)
+                    rotations[count++] = next;
+            }
+        }
+
+        for (int a = 0; a < 24; a++)
+        {
+            integer[a] = IntMat3(rotations[a]);
+            inverse[a] = IntMat3(glm::transpose(rotations[a]));
+            for (int b = 0; b < 24; b++)
+                product[a][b] = Find(rotations[a] * rotations[b], 24);
+        }
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            glm::vec3 v(0.0f);
+            v[axis] = 1.0f;
+            for (int turns = 0; turns < 4; turns++)
+                quarterTurns[axis][turns] = Find(Round(glm::mat3(glm::rotate(glm::mat4(1.0f), glm::radians(90.0f * turns), v))), 24);
+        }
+    }
+
+    static glm::mat3 Round(glm::mat3 m)
+    {
+        for (int c = 0; c < 3; c++)
+            for (int r = 0; r < 3; r++)
+                m[c][r] = std::round(m[c][r]);
+        return m;
+    }
+
+    int Find(const glm::mat3& m, int count) const
+    {
+        for (int i = 0; i < count; i++)
+            if (rotations[i] == m) return i;
+        return -1;
+    }
+};
+
+static const RotationTables& GetTables()
+{
+    static const RotationTables tables;
+    return tables;
+}
+
+const glm::mat3& GetCubeRotation(int index)
+{
+    return GetTables().rotations[index];
+}
+
+int FindCubeRotation(const glm::mat3& rotation)
+{
+    // Largest Frobenius product = smallest rotation angle between the two
+    int best = 0;
+    float bestScore = -1e9f;
+    for (int i = 0; i < 24; i++)
+    {
+        const glm::mat3& r = GetTables().rotations[i];
+        float score = glm::dot(r[0], rotation[0]) + glm::dot(r[1], rotation[1]) + glm::dot(r[2], rotation[2]);
+        if (score > bestScore)
+        {
+            best = i;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+// Slot coordinates are doubled and centered (2 * x - (N - 1)) so rotations stay on integers
+static glm::ivec3 SlotToCentered(int slot, int size)
+{
+    glm::ivec3 p(slot / (size * size), (slot / size) % size, slot % size);
+    return 2 * p - glm::ivec3(size - 1);
+}
+
+static int CenteredToSlot(const glm::ivec3& centered, int size)
+{
+    glm::ivec3 p = (centered + glm::ivec3(size - 1)) / 2;
+    return (p.x * size + p.y) * size + p.z;
+}
+
+static int FaceFromNormal(const glm::ivec3& normal)
+{
+    for (int f = 0; f < 6; f++)
+        if (FACE_NORMALS[f] == normal) return f;
+    return -1;
+}
+
+// True if a cubie at the (centered) position shows a sticker on the face
+static bool IsOnFace(const glm::ivec3& centered, int face, int size)
+{
+    glm::ivec3 p = centered * FACE_NORMALS[face];
+    return p.x + p.y + p.z == size - 1;
+}
+
+void CubeState::Reset(int cubeSize)
+{
+    size = cubeSize;
+    slots.resize((size_t)size * size * size);
+    orientations.assign(slots.size(), 0);
+    for (size_t i = 0; i < slots.size(); i++)
+        slots[i] = (uint32_t)i;
+}
+
+void CubeState::ApplyMove(const Move& move)
+{
+    int turns = ((move.quarterTurns % 4) + 4) % 4;
+    if (turns == 0)
+        return;
+
+    const RotationTables& tables = GetTables();
+    int turn = tables.quarterTurns[move.axis][turns];
+    int layer = 2 * move.layer - (size - 1);
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        glm::ivec3 p = SlotToCentered(slots[i], size);
+        if (p[move.axis] != layer)
+            continue;
+
+        slots[i] = (uint32_t)CenteredToSlot(tables.integer[turn] * p, size);
+        orientations[i] = (uint8_t)tables.product[turn][orientations[i]];
+    }
+}
+
+bool CubeState::operator==(const CubeState& other) const
+{
+    return size == other.size && slots == other.slots && orientations == other.orientations;
+}
+
+static int GetSlotBits(int cubeSize)
+{
+    uint64_t count = (uint64_t)cubeSize * cubeSize * cubeSize;
+    int bits = 0;
+    while (((uint64_t)1 << bits) < count)
+        bits++;
+    return bits;
+}
+
+size_t GetPackedStateSize(int cubeSize)
+{
+    size_t count = (size_t)cubeSize * cubeSize * cubeSize;
+    return (count * (GetSlotBits(cubeSize) + 5) + 7) / 8;
+}
+
+void PackState(const CubeState& state, unsigned char* out)
+{
+    std::fill(out, out + GetPackedStateSize(state.size), 0);
+
+    int slotBits = GetSlotBits(state.size);
+    size_t bit = 0;
+    auto put = [&](unsigned int value, int bits)
+    {
+        for (int i = 0; i < bits; i++, bit++)
+            out[bit / 8] |= (unsigned char)(((value >> i) & 1) << (bit % 8));
+    };
+
+    for (size_t i = 0; i < state.slots.size(); i++)
+    {
+        put(state.slots[i], slotBits);
+        put(state.orientations[i], 5);
+    }
+}
+
+bool UnpackState(const unsigned char* data, int cubeSize, CubeState& state)
+{
+    state.Reset(cubeSize);
+
+    int slotBits = GetSlotBits(cubeSize);
+    size_t bit = 0;
+    auto get = [&](int bits)
+    {
+        unsigned int value = 0;
+        for (int i = 0; i < bits; i++, bit++)
+            value |= (unsigned int)((data[bit / 8] >> (bit % 8)) & 1) << i;
+        return value;
+    };
+
+    std::vector<bool> used(state.slots.size(), false);
+    for (size_t i = 0; i < state.slots.size(); i++)
+    {
+        unsigned int slot = get(slotBits);
+        unsigned int orientation = get(5);
+        if (slot >= used.size() || used[slot] || orientation >= 24)
+            return false;
+
+        // The rotation has to carry the cubie from its solved slot to this one
+        glm::ivec3 home = SlotToCentered((int)i, cubeSize);
+        if (GetTables().integer[orientation] * home != SlotToCentered((int)slot, cubeSize))
+            return false;
+
+        used[slot] = true;
+        state.slots[i] = (uint32_t)slot;
+        state.orientations[i] = (uint8_t)orientation;
+    }
+    return true;
+}
+
+// Slot of the sticker at row, column of a facelet face (0 - 5 in URFDLB order)
+static glm::ivec3 GetFaceletPosition(int face, int row, int column, int size)
+{
+    int l = size - 1;
+    switch (face)
+    {
+    case 0:  return { column, l, row };               // U, back row first
+    case 1:  return { l, l - row, l - column };       // R, front column first
+    case 2:  return { column, l - row, l };           // F
+    case 3:  return { column, 0, l - row };           // D, front row first
+    case 4:  return { 0, l - row, column };           // L, back column first
+    default: return { l - column, l - row, 0 };       // B, right column first
+    }
+}
+
+std::string StateToFacelets(const CubeState& state)
+{
+    int n = state.size;
+    std::vector<int> cubieInSlot(state.slots.size());
+    for (size_t i = 0; i < state.slots.size(); i++)
+        cubieInSlot[state.slots[i]] = (int)i;
+
+    std::string facelets;
+    facelets.reserve((size_t)6 * n * n);
+    for (int f = 0; f < 6; f++)
+    {
+        for (int row = 0; row < n; row++)
+        {
+            for (int column = 0; column < n; column++)
+            {
+                glm::ivec3 p = GetFaceletPosition(f, row, column, n);
+                int id = cubieInSlot[(p.x * n + p.y) * n + p.z];
+
+                // Turn the world normal back into the cubie's own frame
+                const IntMat3& inverse = GetTables().inverse[state.orientations[id]];
+                int local = FaceFromNormal(inverse * FACE_NORMALS[FACELET_FACES[f]]);
+                facelets += IsOnFace(SlotToCentered(id, n), local, n) ? FACE_LETTERS[local] : '?';
+            }
+        }
+    }
+    return facelets;
+}
+
+bool FaceletsToState(const std::string& facelets, int cubeSize, CubeState& state, std::string* error)
+{
+    int n = cubeSize;
+    if (facelets.size() != (size_t)6 * n * n)
+    {
+        if (error)
+            *error = "expected " + std::to_string(6 * n * n) + " facelets, got " + std::to_string(facelets.size());
+        return false;
+    }
+
+    // Letter wanted on each (slot, world face), 0 where there is no sticker
+    size_t slotCount = (size_t)n * n * n;
+    std::vector<char> wanted(slotCount * 6, 0);
+    for (int f = 0; f < 6; f++)
+    {
+        for (int row = 0; row < n; row++)
+        {
+            for (int column = 0; column < n; column++)
+            {
+                char letter = facelets[((size_t)f * n + row) * n + column];
+                if (std::find(FACE_LETTERS, FACE_LETTERS + 6, letter) == FACE_LETTERS + 6)
+                {
+                    if (error)
+                        *error = std::string("invalid facelet '") + letter + "'";
+                    return false;
+                }
+
+                glm::ivec3 p = GetFaceletPosition(f, row, column, n);
+                wanted[((p.x * n + p.y) * n + p.z) * 6 + FACELET_FACES[f]] = letter;
+            }
+        }
+    }
+
+    // Rotations only move a cubie among slots at the same distances from the center
+    auto orbit = [n](int slot)
+    {
+        glm::ivec3 p = glm::abs(SlotToCentered(slot, n));
+        int key[3] = { p.x, p.y, p.z };
+        std::sort(key, key + 3);
+        return (key[0] * 64 + key[1]) * 64 + key[2];
+    };
+    std::map<int, std::vector<int>> unused;
+    for (int id = 0; id < (int)slotCount; id++)
+        unused[orbit(id)].push_back(id);
+
+    // Fill every slot with the first unused cubie that shows the wanted letters.
+    // Pieces that look the same (big cube centers) are interchangeable.
+    state.Reset(n);
+    const RotationTables& tables = GetTables();
+    for (int slot = 0; slot < (int)slotCount; slot++)
+    {
+        glm::ivec3 target = SlotToCentered(slot, n);
+        std::vector<int>& candidates = unused[orbit(slot)];
+        bool found = false;
+
+        for (size_t c = 0; c < candidates.size() && !found; c++)
+        {
+            glm::ivec3 home = SlotToCentered(candidates[c], n);
+            for (int r = 0; r < 24 && !found; r++)
+            {
+                if (tables.integer[r] * home != target)
+                    continue;
+
+                found = true;
+                for (int f = 0; f < 6 && found; f++)
+                {
+                    if (!IsOnFace(target, f, n))
+                        continue;
+                    int local = FaceFromNormal(tables.inverse[r] * FACE_NORMALS[f]);
+                    found = IsOnFace(home, local, n) && FACE_LETTERS[local] == wanted[(size_t)slot * 6 + f];
+                }
+
+                if (found)
+                {
+                    state.slots[candidates[c]] = (uint32_t)slot;
+                    state.orientations[candidates[c]] = (uint8_t)r;
+                    candidates.erase(candidates.begin() + c);
+                }
+            }
+        }
+
+        if (!found)
+        {
+            glm::ivec3 p = (target + glm::ivec3(n - 1)) / 2;
+            if (error)
+                *error = "no piece matches the stickers at (" + std::to_string(p.x) + ", " + std::to_string(p.y) +
+                         ", " + std::to_string(p.z) + ")";
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Move.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Where every cubie of an N x N cube is and how it is turned, indexed by cubie ID.
+// IDs and slots use the same numbering, (x * N + y) * N + z, so a solved cube has
+// slots[id] == id. Stickers stay fixed to their cubie and need no storage.
+// This is all RubiksCube::GetState/SetState exchange, without any GL.
+struct CubeState
+{
+    int size = 0;
+    std::vector<uint32_t> slots;       // current slot of each cubie
+    std::vector<uint8_t> orientations; // index into GetCubeRotation
+
+    // Solved cube of the given size
+    void Reset(int cubeSize);
+    // Same result as RubiksCube::ApplyMove, on integers only
+    void ApplyMove(const Move& move);
+
+    bool operator==(const CubeState& other) const;
+    bool operator!=(const CubeState& other) const { return !(*this == other); }
+};
+
+// Largest size a state can describe: slot numbers (up to N^3 - 1) are computed
+// as int, here and in RubiksCube
+const int MAX_STATE_CUBE_SIZE = 1290;
+static_assert((long long)MAX_STATE_CUBE_SIZE * MAX_STATE_CUBE_SIZE * MAX_STATE_CUBE_SIZE <= 2147483647LL,
+              "slot numbers have to fit an int");
+
+// The 24 rotations of a cube (0 is the identity)
+const glm::mat3& GetCubeRotation(int index);
+// Index of the closest of the 24 to any rotation
+int FindCubeRotation(const glm::mat3& rotation);
+
+// Bit-packed form used by CubeFile: each cubie's slot (as few bits as the size
+// needs) followed by its orientation (5 bits), padded to a whole byte
+size_t GetPackedStateSize(int cubeSize);
+void PackState(const CubeState& state, unsigned char* out);
+// False if the data is not a valid state (not a permutation, impossible rotation)
+bool UnpackState(const unsigned char* data, int cubeSize, CubeState& state);
+
+// Facelet strings: 6 * N * N letters naming the face each sticker belongs to, with
+// the faces in U R F D L B order, each read row by row as laid out in the usual net
+// (U with B at the top, D with F at the top, the side faces upright). On a 3x3
+// this is the common 54-character format, "UUUUUUUUURRRRRRRRRFFF..." when solved.
+std::string StateToFacelets(const CubeState& state);
+// Centers can't show how they are turned, so they come back unrotated
+bool FaceletsToState(const std::string& facelets, int cubeSize, CubeState& state, std::string* error = nullptr);
@@ -18,7 +18,7 @@ enum class Face
     NegX = 5  // Left
 };
 
-static glm::vec4 StickerToVec4(StickerColor color)
+inline glm::vec4 StickerToVec4(StickerColor color)
 {
     switch (color)
     {
@@ -40,9 +40,18 @@ struct Cubie
     glm::mat4 localRotation;
     StickerColor stickers[6];
     glm::vec3 translationOffset = glm::vec3(0.0f);
+    bool desynced = false; // moved or rotated by hand, may leave its grid slot
 
     Cubie() : id(0), currentGridPos(0), localRotation(1.0f) {}
 
+    // False for the hidden inner pieces of cubes bigger than 2x2
+    bool HasStickers() const
+    {
+        for (int i = 0; i < 6; i++)
+            if (stickers[i] != StickerColor::None) return true;
+        return false;
+    }
+
     glm::mat4 BuildModel(const glm::vec3& slotWorldPos, const glm::mat4& wallAnimRotation, float uniformScale) const;
 
     void ApplyLocalRotation(const glm::mat4& rot);
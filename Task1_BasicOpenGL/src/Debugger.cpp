@@ -1,4 +1,5 @@
 #include <Debugger.h>
+#include <GLExtensions.h>
 
 void GLClearError()
 {
@@ -13,4 +14,81 @@ bool GLLogCall(const char* function, const char* file, int line)
         return false;
     }
     return true;
-}
\ No newline at end of file
+}
+
+GLCallSite GLLastCallSite;
+
+bool ParseGLDebugLevel(const std::string& name, GLDebugLevel& level)
+{
+    if (name == "off")         level = GLDebugLevel::Off;
+    else if (name == "high")   level = GLDebugLevel::High;
+    else if (name == "medium") level = GLDebugLevel::Medium;
+    else if (name == "low")    level = GLDebugLevel::Low;
+    else if (name == "all")    level = GLDebugLevel::Notification;
+    else return false;
+    return true;
+}
+
+static const char* GetDebugSeverityName(GLenum severity)
+{
+    switch (severity)
+    {
+    case GL_DEBUG_SEVERITY_HIGH:         return "high";
+    case GL_DEBUG_SEVERITY_MEDIUM:       return "medium";
+    case GL_DEBUG_SEVERITY_LOW:          return "low";
+    case GL_DEBUG_SEVERITY_NOTIFICATION: return "notification";
+    default:                             return "?";
+    }
+}
+
+static const char* GetDebugTypeName(GLenum type)
+{
+    switch (type)
+    {
+    case GL_DEBUG_TYPE_ERROR:               return "error";
+    case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated";
+    case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  return "undefined behavior";
+    case GL_DEBUG_TYPE_PORTABILITY:         return "portability";
+    case GL_DEBUG_TYPE_PERFORMANCE:         return "performance";
+    default:                                return "other";
+    }
+}
+
+static void APIENTRY PrintDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
+                                       const GLchar* message, const void* userParam)
+{
+    std::cout << "[OpenGL " << GetDebugSeverityName(severity) << " " << GetDebugTypeName(type) << "] (" << id << "): " << message;
+    if (GLLastCallSite.function)
+        std::cout << "\n    last GLCall: " << GLLastCallSite.function << " " << GLLastCallSite.file << ":" << GLLastCallSite.line;
+    std::cout << std::endl;
+}
+
+bool EnableGLDebugOutput(GLDebugLevel level)
+{
+    if (level == GLDebugLevel::Off)
+        return true;
+
+    if (!GLExt_Debug)
+    {
+        std::cout << "OpenGL debug output is not supported (KHR_debug)" << std::endl;
+        return false;
+    }
+
+    int flags = 0;
+    glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+    if (!(flags & GL_CONTEXT_FLAG_DEBUG_BIT))
+        std::cout << "OpenGL debug output: not a debug context, the driver may report little" << std::endl;
+
+    glEnable(GL_DEBUG_OUTPUT);
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    glDebugMessageCallback(PrintDebugMessage, nullptr);
+
+    // Filtered by the driver, messages below the level are never generated
+    const GLenum severities[] = { GL_DEBUG_SEVERITY_HIGH, GL_DEBUG_SEVERITY_MEDIUM, GL_DEBUG_SEVERITY_LOW, GL_DEBUG_SEVERITY_NOTIFICATION };
+    for (int i = 0; i < 4; i++)
+    {
+        bool enabled = i < (int)level;
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, severities[i], 0, nullptr, enabled ? GL_TRUE : GL_FALSE);
+    }
+    return true;
+}
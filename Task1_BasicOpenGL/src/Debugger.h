@@ -3,6 +3,7 @@
 #include <glad/glad.h>
 
 #include <iostream>
+#include <string>
 
 // #define ASSERT(x) if (!(x)) __debugbreak();
 
@@ -18,9 +19,67 @@
 #define ASSERT(x) if (!(x)) raise(SIGTRAP);
 #endif
 
-#define GLCall(x) GLClearError();\
+// Where the last GLCall is, so debug output messages can name it. Recorded
+// with ENABLE_GL_CALLSITE only (make GL_CALLSITE=1, on by default along with
+// GL_CHECKS).
+struct GLCallSite
+{
+    const char* function = nullptr;
+    const char* file = nullptr;
+    int line = 0;
+};
+
+extern GLCallSite GLLastCallSite; // GL thread only
+
+inline void GLSetCallSite(const char* function, const char* file, int line)
+{
+    GLLastCallSite.function = function;
+    GLLastCallSite.file = file;
+    GLLastCallSite.line = line;
+}
+
+#ifdef ENABLE_GL_CALLSITE
+#define GLRecordCallSite(x) GLSetCallSite(#x, __FILE__, __LINE__);
+#else
+#define GLRecordCallSite(x)
+#endif
+
+// glGetError around every call (make GL_CHECKS=1, the default). Each check
+// waits on the driver, so release builds (make GL_CHECKS=0) make the bare call
+// and leave error reporting to the debug output below.
+//
+// GLCall expands to several statements, not a block, so GLCall(int n = glGet...)
+// declares n in the enclosing scope. The flip side: never use it as the only
+// statement of an unbraced if/else/for/while, which would guard just the first.
+#ifdef ENABLE_GL_CHECKS
+#define GLCall(x) GLRecordCallSite(x)\
+    GLClearError();\
     x;\
     ASSERT(GLLogCall(#x, __FILE__, __LINE__));
+#else
+#define GLCall(x) GLRecordCallSite(x)\
+    x;
+#endif
 
 void GLClearError();
-bool GLLogCall(const char* function, const char* file, int line);
\ No newline at end of file
+bool GLLogCall(const char* function, const char* file, int line);
+
+// Lowest severity of the debug output messages printed
+enum class GLDebugLevel
+{
+    Off,
+    High,         // errors and undefined behavior
+    Medium,       // plus major performance warnings
+    Low,          // plus redundant state changes and the like
+    Notification  // everything, e.g. buffer placement
+};
+
+// "off", "high", "medium", "low" or "all"
+bool ParseGLDebugLevel(const std::string& name, GLDebugLevel& level);
+
+// KHR_debug (core since 4.3): prints the driver's messages at level and above
+// for the current context, with the GLCall that was running when they came
+// (if call sites are recorded). Messages arrive synchronously, so that is the
+// culprit unless it was a bare gl* call. Drivers only report much from a debug context. False (after
+// printing why) if the context has no debug output.
+bool EnableGLDebugOutput(GLDebugLevel level);
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include <FrameCapture.h>
+#include <Profiler.h>
+
+#include <stb/stb_image_write.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+FrameCapture::FrameCapture(int width, int height, CaptureFormat format, const std::string& outputPath,
+                           int ringSize, size_t maxQueued)
+    : m_Width(width), m_Height(height), m_Format(format), m_OutputPath(outputPath), m_Stream(nullptr),
+      m_Slots(nullptr), m_SlotCount(std::max(2, ringSize)), m_NextSlot(0), m_FrameIndex(0), m_Dropped(0),
+      m_Encoder(1, maxQueued)
+{
+    // 4:2:0 needs even dimensions, drop the last row/column if necessary
+    if (m_Format == CaptureFormat::Y4m)
+    {
+        m_Width &= ~1;
+        m_Height &= ~1;
+    }
+
+    if (m_Format == CaptureFormat::Png)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(m_OutputPath, ec);
+        if (ec)
+            std::cout << "Capture: cannot create " << m_OutputPath << ": " << ec.message() << std::endl;
+    }
+    else
+    {
+        m_Stream = std::fopen(m_OutputPath.c_str(), "wb");
+        if (!m_Stream)
+            std::cout << "Capture: cannot open " << m_OutputPath << std::endl;
+        else if (m_Format == CaptureFormat::Y4m)
+            std::fprintf(m_Stream, "YUV4MPEG2 W%d H%d F60:1 Ip A1:1 C420jpeg\n", m_Width, m_Height);
+    }
+
+    m_Slots = new Slot[m_SlotCount];
+    for (int i = 0; i < m_SlotCount; i++)
+    {
+        GLCall(glGenBuffers(1, &m_Slots[i].pixelBuffer));
+        GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_Slots[i].pixelBuffer));
+        GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, (size_t)m_Width * m_Height * 4, nullptr, GL_STREAM_READ));
+    }
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+}
+
+FrameCapture::~FrameCapture()
+{
+    Finish();
+
+    for (int i = 0; i < m_SlotCount; i++)
+    {
+        GLCall(glDeleteBuffers(1, &m_Slots[i].pixelBuffer));
+    }
+    delete[] m_Slots;
+
+    if (m_Stream)
+        std::fclose(m_Stream);
+}
+
+bool FrameCapture::ParseFormat(const std::string& name, CaptureFormat& format)
+{
+    if (name == "png")      format = CaptureFormat::Png;
+    else if (name == "y4m") format = CaptureFormat::Y4m;
+    else if (name == "raw") format = CaptureFormat::Raw;
+    else return false;
+    return true;
+}
+
+const char* FrameCapture::GetDefaultPath(CaptureFormat format)
+{
+    switch (format)
+    {
+    case CaptureFormat::Png: return "capture";
+    case CaptureFormat::Y4m: return "capture.y4m";
+    case CaptureFormat::Raw: return "capture.rgba";
+    }
+    return "capture";
+}
+
+void FrameCapture::CaptureFrame()
+{
+    PROFILE_SCOPE("FrameCapture::CaptureFrame");
+    if (!IsValid())
+        return;
+
+    // Collect every readback that has landed, oldest first so frames stay in order
+    for (int i = 0; i < m_SlotCount; i++)
+    {
+        Slot& slot = m_Slots[(m_NextSlot + i) % m_SlotCount];
+        if (!slot.fence || !CollectSlot(slot, false))
+            break;
+    }
+
+    // GPU is a whole ring behind: skip this frame instead of waiting
+    Slot& slot = m_Slots[m_NextSlot];
+    if (slot.fence)
+    {
+        m_Dropped++;
+        return;
+    }
+
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pixelBuffer));
+    GLCall(glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+    GLCall(slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+    m_NextSlot = (m_NextSlot + 1) % m_SlotCount;
+}
+
+void FrameCapture::Finish()
+{
+    for (int i = 0; i < m_SlotCount; i++)
+    {
+        Slot& slot = m_Slots[(m_NextSlot + i) % m_SlotCount];
+        if (slot.fence)
+            CollectSlot(slot, true);
+    }
+    m_Encoder.Wait();
+
+    if (m_Stream)
+        std::fflush(m_Stream);
+}
+
+bool FrameCapture::CollectSlot(Slot& slot, bool wait)
+{
+    GLCall(GLenum state = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? 1000000000 : 0));
+    if (state != GL_ALREADY_SIGNALED && state != GL_CONDITION_SATISFIED)
+        return false;
+
+    GLCall(glDeleteSync(slot.fence));
+    slot.fence = nullptr;
+
+    size_t size = (size_t)m_Width * m_Height * 4;
+    std::vector<unsigned char> pixels(size);
+
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pixelBuffer));
+    GLCall(const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT));
+    if (data)
+        std::memcpy(pixels.data(), data, size);
+    GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    // Back-pressure: a full encoder queue costs this frame, never the render loop
+    // Numbered once the frame is sure to be written, ffmpeg's %06d input stops at a gap
+    int frame = m_FrameIndex;
+    if (data && m_Encoder.TrySubmit([this, pixels = std::move(pixels), frame] { EncodeFrame(pixels.data(), frame); }))
+        m_FrameIndex++;
+    else
+        m_Dropped++;
+
+    return true;
+}
+
+// Runs on the encoder thread. Rows arrive bottom-up from glReadPixels.
+void FrameCapture::EncodeFrame(const unsigned char* pixels, int frame)
+{
+    int rowBytes = m_Width * 4;
+    const unsigned char* topRow = pixels + (size_t)(m_Height - 1) * rowBytes;
+
+    if (m_Format == CaptureFormat::Png)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%06d.png", frame);
+        std::string path = (std::filesystem::path(m_OutputPath) / name).string();
+
+        // Negative stride walks the rows top to bottom
+        if (!stbi_write_png(path.c_str(), m_Width, m_Height, 4, topRow, -rowBytes))
+            std::cout << "Capture: failed to write " << path << std::endl;
+    }
+    else if (m_Format == CaptureFormat::Raw)
+    {
+        for (int y = 0; y < m_Height; y++)
+            std::fwrite(topRow - (size_t)y * rowBytes, 1, rowBytes, m_Stream);
+    }
+    else
+    {
+        // Full range BT.601 (C420jpeg), chroma averaged over 2x2 blocks
+        std::vector<unsigned char> planes((size_t)m_Width * m_Height * 3 / 2);
+        unsigned char* yPlane = planes.data();
+        unsigned char* uPlane = yPlane + (size_t)m_Width * m_Height;
+        unsigned char* vPlane = uPlane + (size_t)m_Width * m_Height / 4;
+
+        for (int y = 0; y < m_Height; y++)
+        {
+            const unsigned char* row = topRow - (size_t)y * rowBytes;
+            for (int x = 0; x < m_Width; x++)
+            {
+                const unsigned char* p = row + x * 4;
+                yPlane[(size_t)y * m_Width + x] = (unsigned char)((77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8);
+            }
+        }
+
+        for (int y = 0; y < m_Height; y += 2)
+        {
+            const unsigned char* row0 = topRow - (size_t)y * rowBytes;
+            const unsigned char* row1 = row0 - rowBytes;
+            for (int x = 0; x < m_Width; x += 2)
+            {
+                int r = row0[x * 4] + row0[x * 4 + 4] + row1[x * 4] + row1[x * 4 + 4];
+                int g = row0[x * 4 + 1] + row0[x * 4 + 5] + row1[x * 4 + 1] + row1[x * 4 + 5];
+                int b = row0[x * 4 + 2] + row0[x * 4 + 6] + row1[x * 4 + 2] + row1[x * 4 + 6];
+
+                size_t index = (size_t)(y / 2) * (m_Width / 2) + x / 2;
+                uPlane[index] = (unsigned char)std::clamp((-43 * r - 85 * g + 128 * b + 512) / 1024 + 128, 0, 255);
+                vPlane[index] = (unsigned char)std::clamp((128 * r - 107 * g - 21 * b + 512) / 1024 + 128, 0, 255);
+            }
+        }
+
+        std::fputs("FRAME\n", m_Stream);
+        std::fwrite(planes.data(), 1, planes.size(), m_Stream);
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Debugger.h>
+#include "WorkerPool.h"
+
+#include <cstdio>
+#include <string>
+
+enum class CaptureFormat
+{
+    Png, // numbered files in a directory
+    Y4m, // one YUV4MPEG2 (4:2:0) stream, plays in ffplay/mpv
+    Raw  // one stream of RGBA8 frames, top row first
+};
+
+// Records the default framebuffer without stalling the render loop. Each
+// frame is copied into one of a ring of pixel buffers and collected once its
+// fence has signaled. A single encoder thread writes the frames in order.
+// When the ring or the encoder queue is full the frame is dropped and counted.
+class FrameCapture
+{
+    private:
+        struct Slot
+        {
+            unsigned int pixelBuffer = 0;
+            GLsync fence = nullptr;
+        };
+
+        int m_Width, m_Height;
+        CaptureFormat m_Format;
+        std::string m_OutputPath;
+        std::FILE* m_Stream; // Y4m and Raw
+        Slot* m_Slots;
+        int m_SlotCount;
+        int m_NextSlot;      // oldest slot, the next one to reuse
+        int m_FrameIndex;    // frames handed to the encoder, the next PNG number
+        int m_Dropped;       // counted apart, so numbers have no gaps
+        WorkerPool m_Encoder;
+    public:
+        FrameCapture(int width, int height, CaptureFormat format, const std::string& outputPath,
+                     int ringSize = 3, size_t maxQueued = 8);
+        ~FrameCapture();
+
+        FrameCapture(const FrameCapture&) = delete;
+        FrameCapture& operator=(const FrameCapture&) = delete;
+
+        // Call after drawing and before swapping buffers
+        void CaptureFrame();
+        // Blocks until every queued frame is written (also done by the destructor)
+        void Finish();
+
+        inline bool IsValid() const { return m_Format == CaptureFormat::Png || m_Stream != nullptr; }
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+        // Frames written (or queued to be), without the dropped ones
+        inline int GetFrameCount() const { return m_FrameIndex; }
+        inline int GetDroppedCount() const { return m_Dropped; }
+
+        // "png", "y4m" or "raw"
+        static bool ParseFormat(const std::string& name, CaptureFormat& format);
+        static const char* GetDefaultPath(CaptureFormat format);
+    private:
+        // Hands a finished readback to the encoder, false if it had to be dropped
+        bool CollectSlot(Slot& slot, bool wait);
+        void EncodeFrame(const unsigned char* pixels, int frame);
+};
@@ -0,0 +1,43 @@
+#include <Framebuffer.h>
+
+Framebuffer::Framebuffer(int width, int height)
+    : m_RendererID(0), m_ColorID(0), m_DepthID(0), m_Width(width), m_Height(height)
+{
+    GLCall(glGenFramebuffers(1, &m_RendererID));
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+
+    GLCall(glGenRenderbuffers(1, &m_ColorID));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_ColorID));
+    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_Width, m_Height));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorID));
+
+    GLCall(glGenRenderbuffers(1, &m_DepthID));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_DepthID));
+    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_Width, m_Height));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_DepthID));
+
+    GLCall(GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "Framebuffer is incomplete (" << status << ")" << std::endl;
+
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
+
+Framebuffer::~Framebuffer()
+{
+    GLCall(glDeleteRenderbuffers(1, &m_ColorID));
+    GLCall(glDeleteRenderbuffers(1, &m_DepthID));
+    GLCall(glDeleteFramebuffers(1, &m_RendererID));
+}
+
+void Framebuffer::Bind() const
+{
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+    GLCall(glViewport(0, 0, m_Width, m_Height));
+}
+
+void Framebuffer::Unbind() const
+{
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
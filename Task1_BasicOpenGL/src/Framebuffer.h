@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Debugger.h>
+
+// Offscreen RGBA8 color + depth target
+class Framebuffer
+{
+    private:
+        unsigned int m_RendererID;
+        unsigned int m_ColorID;
+        unsigned int m_DepthID;
+        int m_Width, m_Height;
+    public:
+        Framebuffer(int width, int height);
+        ~Framebuffer();
+
+        Framebuffer(const Framebuffer&) = delete;
+        Framebuffer& operator=(const Framebuffer&) = delete;
+
+        // Also sets the viewport to the whole target
+        void Bind() const;
+        void Unbind() const;
+
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+};
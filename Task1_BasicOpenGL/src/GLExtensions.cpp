@@ -0,0 +1,65 @@
+#include <GLExtensions.h>
+
+#include <cstring>
+
+PFNGLGETPROGRAMBINARYPROC glad_glGetProgramBinary = nullptr;
+PFNGLPROGRAMBINARYPROC glad_glProgramBinary = nullptr;
+PFNGLPROGRAMPARAMETERIPROC glad_glProgramParameteri = nullptr;
+PFNGLDEBUGMESSAGECALLBACKPROC glad_glDebugMessageCallback = nullptr;
+PFNGLDEBUGMESSAGECONTROLPROC glad_glDebugMessageControl = nullptr;
+
+bool GLExt_ProgramBinary = false;
+bool GLExt_TextureS3TC = false;
+bool GLExt_TextureBPTC = false;
+bool GLExt_TextureETC2 = false;
+bool GLExt_Debug = false;
+
+bool HasGLExtension(const char* name, int coreMajor, int coreMinor)
+{
+    if (GLVersion.major > coreMajor || (GLVersion.major == coreMajor && GLVersion.minor >= coreMinor))
+        return true;
+
+    return HasGLExtension(name);
+}
+
+bool HasGLExtension(const char* name)
+{
+    int count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (int i = 0; i < count; i++)
+    {
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+        if (extension && std::strcmp(extension, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+void LoadGLExtensions(GLADloadproc load)
+{
+    if (HasGLExtension("GL_ARB_get_program_binary", 4, 1))
+    {
+        glad_glGetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)load("glGetProgramBinary");
+        glad_glProgramBinary = (PFNGLPROGRAMBINARYPROC)load("glProgramBinary");
+        glad_glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)load("glProgramParameteri");
+
+        // Drivers may expose the entry points but support zero binary formats
+        int formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+        GLExt_ProgramBinary = glad_glGetProgramBinary && glad_glProgramBinary && glad_glProgramParameteri && formats > 0;
+    }
+
+    // Compressed formats only need the tokens, glCompressedTexImage2D is core
+    GLExt_TextureS3TC = HasGLExtension("GL_EXT_texture_compression_s3tc");
+    GLExt_TextureBPTC = HasGLExtension("GL_ARB_texture_compression_bptc", 4, 2);
+    GLExt_TextureETC2 = HasGLExtension("GL_ARB_ES3_compatibility", 4, 3);
+
+    // On desktop GL the KHR_debug entry points have no suffix
+    if (HasGLExtension("GL_KHR_debug", 4, 3))
+    {
+        glad_glDebugMessageCallback = (PFNGLDEBUGMESSAGECALLBACKPROC)load("glDebugMessageCallback");
+        glad_glDebugMessageControl = (PFNGLDEBUGMESSAGECONTROLPROC)load("glDebugMessageControl");
+        GLExt_Debug = glad_glDebugMessageCallback && glad_glDebugMessageControl;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// The bundled glad loader only covers the OpenGL 3.3 core profile.
+// Newer core features that we use opportunistically are loaded here,
+// following the same naming scheme glad uses, so call sites look like plain GL.
+
+// GL_ARB_get_program_binary (core since 4.1)
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+
+extern PFNGLGETPROGRAMBINARYPROC glad_glGetProgramBinary;
+extern PFNGLPROGRAMBINARYPROC glad_glProgramBinary;
+extern PFNGLPROGRAMPARAMETERIPROC glad_glProgramParameteri;
+#define glGetProgramBinary glad_glGetProgramBinary
+#define glProgramBinary glad_glProgramBinary
+#define glProgramParameteri glad_glProgramParameteri
+
+// GL_EXT_texture_compression_s3tc (BC1 - BC3, never made core)
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+
+// GL_ARB_texture_compression_bptc (BC7, core since 4.2)
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+
+// GL_ARB_ES3_compatibility (ETC2, core since 4.3)
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+
+// GL_KHR_debug (core since 4.3)
+#define GL_DEBUG_OUTPUT 0x92E0
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#define GL_CONTEXT_FLAG_DEBUG_BIT 0x00000002
+#define GL_DEBUG_TYPE_ERROR 0x824C
+#define GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR 0x824D
+#define GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR 0x824E
+#define GL_DEBUG_TYPE_PORTABILITY 0x824F
+#define GL_DEBUG_TYPE_PERFORMANCE 0x8250
+#define GL_DEBUG_SEVERITY_HIGH 0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM 0x9147
+#define GL_DEBUG_SEVERITY_LOW 0x9148
+#define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+
+typedef void (APIENTRYP PFNGLDEBUGMESSAGECALLBACKPROC)(GLDEBUGPROC callback, const void* userParam);
+typedef void (APIENTRYP PFNGLDEBUGMESSAGECONTROLPROC)(GLenum source, GLenum type, GLenum severity, GLsizei count, const GLuint* ids, GLboolean enabled);
+
+extern PFNGLDEBUGMESSAGECALLBACKPROC glad_glDebugMessageCallback;
+extern PFNGLDEBUGMESSAGECONTROLPROC glad_glDebugMessageControl;
+#define glDebugMessageCallback glad_glDebugMessageCallback
+#define glDebugMessageControl glad_glDebugMessageControl
+
+// Availability flags, valid after LoadGLExtensions
+extern bool GLExt_ProgramBinary;
+extern bool GLExt_TextureS3TC;
+extern bool GLExt_TextureBPTC;
+extern bool GLExt_TextureETC2;
+extern bool GLExt_Debug;
+
+// Call once right after gladLoadGLLoader, with the same loader
+void LoadGLExtensions(GLADloadproc load);
+
+// True if the context advertises the extension
+bool HasGLExtension(const char* name);
+
+// True if the context is at least major.minor or advertises the extension
+bool HasGLExtension(const char* name, int coreMajor, int coreMinor);
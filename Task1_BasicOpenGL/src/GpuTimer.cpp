@@ -0,0 +1,59 @@
+#include <GpuTimer.h>
+
+GpuTimer::GpuTimer()
+    : m_Oldest(0), m_Pending(0), m_Active(false), m_LastMs(0.0), m_HasResult(false)
+{
+    GLCall(glGenQueries(QUERY_COUNT, m_Queries));
+}
+
+GpuTimer::~GpuTimer()
+{
+    if (m_Active)
+    {
+        GLCall(glEndQuery(GL_TIME_ELAPSED));
+    }
+    GLCall(glDeleteQueries(QUERY_COUNT, m_Queries));
+}
+
+void GpuTimer::Begin()
+{
+    if (m_Active || m_Pending == QUERY_COUNT)
+        return;
+
+    int next = (m_Oldest + m_Pending) % QUERY_COUNT;
+    GLCall(glBeginQuery(GL_TIME_ELAPSED, m_Queries[next]));
+    m_Active = true;
+}
+
+void GpuTimer::End()
+{
+    if (!m_Active)
+        return;
+
+    GLCall(glEndQuery(GL_TIME_ELAPSED));
+    m_Active = false;
+    m_Pending++;
+}
+
+bool GpuTimer::Update()
+{
+    bool updated = false;
+    while (m_Pending > 0)
+    {
+        // Queries finish in order, the oldest one decides
+        GLint available = 0;
+        GLCall(glGetQueryObjectiv(m_Queries[m_Oldest], GL_QUERY_RESULT_AVAILABLE, &available));
+        if (!available)
+            break;
+
+        GLuint64 nanoseconds = 0;
+        GLCall(glGetQueryObjectui64v(m_Queries[m_Oldest], GL_QUERY_RESULT, &nanoseconds));
+        m_LastMs = nanoseconds / 1e6;
+        m_HasResult = true;
+        updated = true;
+
+        m_Oldest = (m_Oldest + 1) % QUERY_COUNT;
+        m_Pending--;
+    }
+    return updated;
+}
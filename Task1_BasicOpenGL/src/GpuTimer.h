@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Debugger.h>
+
+// GL_TIME_ELAPSED query around one pass. Results are collected a few frames
+// later, once the GPU has them, so timing never stalls the pipeline; a pass
+// is left untimed while every query is still in flight.
+// Timer queries cannot nest, only one pass may be timed at a time.
+class GpuTimer
+{
+    private:
+        static const int QUERY_COUNT = 4;
+
+        unsigned int m_Queries[QUERY_COUNT];
+        int m_Oldest;  // first query in flight
+        int m_Pending; // queries in flight, from m_Oldest on
+        bool m_Active; // between Begin and End
+        double m_LastMs;
+        bool m_HasResult;
+    public:
+        GpuTimer();
+        ~GpuTimer();
+
+        GpuTimer(const GpuTimer&) = delete;
+        GpuTimer& operator=(const GpuTimer&) = delete;
+
+        void Begin();
+        void End();
+
+        // Reads every query that has finished, true if a new time came in
+        bool Update();
+
+        // Last collected time, 0 before the first one
+        inline double GetMilliseconds() const { return m_LastMs; }
+        inline bool HasResult() const { return m_HasResult; }
+};
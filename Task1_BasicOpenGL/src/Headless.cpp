@@ -0,0 +1,328 @@
+#include "Headless.h"
+
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <stb/stb_image_write.h>
+
+#include "Camera.h"
+#include "CubeFile.h"
+#include "CubeRenderer.h"
+#include "Framebuffer.h"
+#include "HeadlessContext.h"
+#include "RubiksCube.h"
+#include "SoftwareRenderer.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Readback of one rendered image, in flight while the next one is drawn
+struct PendingImage
+{
+    unsigned int pixelBuffer = 0;
+    GLsync fence = nullptr;
+    std::string path;
+};
+
+// Waits for a readback, then hands the pixels to the encoder pool
+static void CollectImage(PendingImage& image, int width, int height, WorkerPool& encoders)
+{
+    if (!image.fence)
+        return;
+
+    GLCall(glClientWaitSync(image.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000));
+    GLCall(glDeleteSync(image.fence));
+    image.fence = nullptr;
+
+    size_t size = (size_t)width * height * 4;
+    std::vector<unsigned char> pixels(size);
+
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, image.pixelBuffer));
+    GLCall(const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT));
+    if (data)
+        std::copy((const unsigned char*)data, (const unsigned char*)data + size, pixels.begin());
+    GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    // PNG compression is the slow part, it runs while the GPU draws the next state
+    encoders.Submit([path = image.path, pixels = std::move(pixels), width, height]()
+    {
+        if (!stbi_write_png(path.c_str(), width, height, 4, pixels.data(), width * 4))
+            std::cout << "Headless: failed to write " << path << std::endl;
+    });
+}
+
+// Batch input: a text file with one scramble or facelet string per line, or a
+// binary state file (CubeFile), which is read straight from the mapping
+class StateSource
+{
+    private:
+        const AppOptions& m_Options;
+        CubeFileReader m_Binary;
+        std::ifstream m_Text;
+        uint32_t m_NextRecord; // states and lines read so far, blank and comment lines aside
+        int m_LineNumber;
+        CubeState m_State;
+        std::unique_ptr<StateFileWriter> m_Output; // --states-out
+    public:
+        StateSource(const AppOptions& options)
+            : m_Options(options), m_Binary(options.headlessInput), m_NextRecord(0), m_LineNumber(0)
+        {
+            if (!IsBinary())
+                m_Text.open(options.headlessInput);
+            if (!options.statesOutput.empty())
+            {
+                m_Output = std::make_unique<StateFileWriter>(options.statesOutput, GetCubeSize());
+                if (!m_Output->IsValid())
+                    std::cout << "Headless: cannot write " << options.statesOutput << std::endl;
+            }
+        }
+
+        bool IsBinary() const { return m_Binary.IsValid() && m_Binary.GetKind() == CubeFileKind::States; }
+        bool IsValid() const { return IsBinary() || m_Text.is_open(); }
+        int GetCubeSize() const { return IsBinary() ? m_Binary.GetCubeSize() : m_Options.cubeSize; }
+
+        // Resets the cube to the next valid state, false at the end of the input.
+        // index is its position in the input, counting the invalid ones too.
+        bool Next(RubiksCube& cube, int& index, int& failed)
+        {
+            if (!Read(cube, index, failed))
+                return false;
+
+            if (m_Output && m_Output->IsValid())
+            {
+                cube.GetState(m_State);
+                m_Output->Write(m_State);
+            }
+            return true;
+        }
+
+    private:
+        bool Read(RubiksCube& cube, int& index, int& failed)
+        {
+            if (IsBinary())
+            {
+                while (m_NextRecord < m_Binary.GetCount())
+                {
+                    index = (int)m_NextRecord++;
+                    if (m_Binary.ReadState(index, m_State) && cube.SetState(m_State))
+                        return true;
+
+                    std::cout << m_Options.headlessInput << ": record " << index << " is not a valid state" << std::endl;
+                    failed++;
+                }
+                return false;
+            }
+
+            std::string line;
+            std::vector<Move> moves;
+            while (std::getline(m_Text, line))
+            {
+                m_LineNumber++;
+                size_t first = line.find_first_not_of(" \t\r");
+                if (first == std::string::npos || line[first] == '#')
+                    continue;
+                index = (int)m_NextRecord++;
+
+                std::string error;
+                std::string facelets = line.substr(first, line.find_last_not_of(" \t\r") + 1 - first);
+                if (IsFaceletString(facelets))
+                {
+                    if (FaceletsToState(facelets, m_Options.cubeSize, m_State, &error) && cube.SetState(m_State))
+                        return true;
+                }
+                else
+                {
+                    moves.clear();
+                    if (ParseMoves(line, m_Options.cubeSize, moves, &error))
+                    {
+                        cube.Init();
+                        for (const Move& move : moves)
+                            cube.ApplyMove(move);
+                        return true;
+                    }
+                }
+
+                std::cout << m_Options.headlessInput << ":" << m_LineNumber << ": " << error << std::endl;
+                failed++;
+            }
+            return false;
+        }
+
+        bool IsFaceletString(const std::string& text) const
+        {
+            size_t count = (size_t)6 * m_Options.cubeSize * m_Options.cubeSize;
+            return text.size() == count && text.find_first_not_of("URFDLB") == std::string::npos;
+        }
+};
+
+static std::string GetImagePath(const AppOptions& options, int index)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%05d.png", index);
+    return (std::filesystem::path(options.outputDir) / name).string();
+}
+
+// Three-quarter view showing the U, F and R faces
+static glm::mat4 GetThumbnailRotation()
+{
+    glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), glm::radians(30.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+    return glm::rotate(rotation, glm::radians(-45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+static Camera MakeThumbnailCamera(const AppOptions& options)
+{
+    return Camera::FrameCube(options.width, options.height, options.cubeSize);
+}
+
+static bool RenderBatchGL(StateSource& input, const AppOptions& options, WorkerPool& encoders, int& written, int& failed)
+{
+    HeadlessContext context(options.glDebug != GLDebugLevel::Off);
+    if (!context.IsValid())
+        return false;
+    EnableGLDebugOutput(options.glDebug);
+
+    // Rows come out of glReadPixels bottom-up
+    stbi_flip_vertically_on_write(1);
+
+    int width = options.width;
+    int height = options.height;
+
+    GLCall(glEnable(GL_DEPTH_TEST));
+    GLCall(glClearColor(0.2f, 0.3f, 0.3f, 1.0f));
+
+    // One target, cube and set of programs for the whole batch
+    Framebuffer target(width, height);
+    Camera camera = MakeThumbnailCamera(options);
+    RubiksCube cube(options.cubeSize);
+    CubeRenderer renderer(options.cubeSize);
+    std::vector<CubieDrawData> draws;
+    glm::mat4 rotation = GetThumbnailRotation();
+
+    PendingImage pending[2];
+    for (auto& image : pending)
+    {
+        GLCall(glGenBuffers(1, &image.pixelBuffer));
+        GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, image.pixelBuffer));
+        GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, (size_t)width * height * 4, nullptr, GL_STREAM_READ));
+    }
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    int index;
+    while (input.Next(cube, index, failed))
+    {
+        // Reuse the slot of two images ago, its readback is done by now
+        PendingImage& image = pending[written % 2];
+        CollectImage(image, width, height, encoders);
+
+        target.Bind();
+        GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        cube.GetDrawData(draws);
+        renderer.Draw(camera.GetViewProjectionMatrix(), rotation, draws);
+
+        image.path = GetImagePath(options, index);
+        GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, image.pixelBuffer));
+        GLCall(glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+        GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+        GLCall(image.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        GLCall(glFlush());
+        written++;
+    }
+
+    // Oldest first so the pool sees the images in order
+    CollectImage(pending[written % 2], width, height, encoders);
+    CollectImage(pending[(written + 1) % 2], width, height, encoders);
+    encoders.Wait();
+
+    for (auto& image : pending)
+    {
+        GLCall(glDeleteBuffers(1, &image.pixelBuffer));
+    }
+    target.Unbind();
+    return true;
+}
+
+static bool RenderBatchSoftware(StateSource& input, const AppOptions& options, WorkerPool& encoders, int& written, int& failed)
+{
+    // The software renderer writes the top row first
+    stbi_flip_vertically_on_write(0);
+
+    int width = options.width;
+    int height = options.height;
+
+    SoftwareRenderer renderer(width, height);
+    Camera camera = MakeThumbnailCamera(options);
+    RubiksCube cube(options.cubeSize);
+    glm::mat4 rotation = GetThumbnailRotation();
+
+    int index;
+    while (input.Next(cube, index, failed))
+    {
+        renderer.Clear(glm::vec4(0.2f, 0.3f, 0.3f, 1.0f));
+        renderer.Draw(cube, camera.GetViewProjectionMatrix(), rotation);
+
+        std::vector<unsigned char> pixels(renderer.GetPixels(), renderer.GetPixels() + (size_t)renderer.GetStride() * height);
+        int stride = renderer.GetStride();
+        encoders.Submit([path = GetImagePath(options, index), pixels = std::move(pixels), width, height, stride]()
+        {
+            if (!stbi_write_png(path.c_str(), width, height, 4, pixels.data(), stride))
+                std::cout << "Headless: failed to write " << path << std::endl;
+        });
+        written++;
+    }
+
+    encoders.Wait();
+    return true;
+}
+
+int RunHeadless(const AppOptions& options)
+{
+    // A state file decides the cube size itself
+    AppOptions batchOptions = options;
+    StateSource input(batchOptions);
+    if (!input.IsValid())
+    {
+        std::cout << "Headless: cannot open " << options.headlessInput << std::endl;
+        return 1;
+    }
+    batchOptions.cubeSize = input.GetCubeSize();
+    if (batchOptions.cubeSize > MAX_CUBE_SIZE)
+    {
+        std::cout << "Headless: " << options.headlessInput << " holds " << batchOptions.cubeSize << "x"
+                  << batchOptions.cubeSize << " cubes, at most " << MAX_CUBE_SIZE << " are supported" << std::endl;
+        return 1;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(options.outputDir, ec);
+    if (ec)
+    {
+        std::cout << "Headless: cannot create " << options.outputDir << ": " << ec.message() << std::endl;
+        return 1;
+    }
+
+    int written = 0, failed = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    // Bounded queue: rendering stalls instead of piling up decoded frames
+    WorkerPool encoders(0, 2 * std::max(1u, std::thread::hardware_concurrency()));
+
+    bool ok = options.software ? RenderBatchSoftware(input, batchOptions, encoders, written, failed)
+                               : RenderBatchGL(input, batchOptions, encoders, written, failed);
+    if (!ok)
+        return 1;
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Headless: " << written << " images in " << seconds << " s -> " << options.outputDir;
+    if (failed > 0)
+        std::cout << " (" << failed << " states skipped)";
+    std::cout << std::endl;
+
+    return failed > 0 ? 2 : 0;
+}
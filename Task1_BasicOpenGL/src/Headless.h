@@ -0,0 +1,7 @@
+#pragma once
+
+#include "CommandLine.h"
+
+// Renders every state listed in options.headlessInput into options.outputDir
+// without creating a window. Returns the process exit code.
+int RunHeadless(const AppOptions& options);
@@ -0,0 +1,92 @@
+#include "HeadlessContext.h"
+
+#include <glad/glad.h>
+#include "GLExtensions.h"
+
+#include <iostream>
+
+#if defined(__linux__)
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+HeadlessContext::HeadlessContext(bool debug)
+    : m_Display(nullptr), m_Context(nullptr)
+{
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (!getPlatformDisplay)
+    {
+        std::cout << "Headless: eglGetPlatformDisplayEXT is not available" << std::endl;
+        return;
+    }
+
+    EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+    {
+        std::cout << "Headless: failed to initialize the surfaceless EGL display" << std::endl;
+        return;
+    }
+    m_Display = display;
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        std::cout << "Headless: EGL has no desktop OpenGL support" << std::endl;
+        return;
+    }
+
+    // No config and no surface: everything is drawn into framebuffer objects
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_CONTEXT_OPENGL_DEBUG, debug ? EGL_TRUE : EGL_FALSE,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        std::cout << "Headless: failed to create an OpenGL 3.3 core context (0x" << std::hex << eglGetError()
+                  << std::dec << ")" << std::endl;
+        if (context != EGL_NO_CONTEXT)
+            eglDestroyContext(display, context);
+        return;
+    }
+
+    if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress))
+    {
+        std::cout << "Headless: failed to load OpenGL functions" << std::endl;
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display, context);
+        return;
+    }
+    LoadGLExtensions((GLADloadproc)eglGetProcAddress);
+
+    m_Context = context;
+    std::cout << "Headless: " << glGetString(GL_RENDERER) << " (EGL " << major << "." << minor << ")" << std::endl;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    if (!m_Display)
+        return;
+
+    eglMakeCurrent((EGLDisplay)m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (m_Context)
+        eglDestroyContext((EGLDisplay)m_Display, (EGLContext)m_Context);
+    eglTerminate((EGLDisplay)m_Display);
+}
+
+#else
+
+HeadlessContext::HeadlessContext(bool debug)
+    : m_Display(nullptr), m_Context(nullptr)
+{
+    std::cout << "Headless: surfaceless contexts are only supported on Linux (EGL)" << std::endl;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+}
+
+#endif
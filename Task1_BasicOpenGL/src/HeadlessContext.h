@@ -0,0 +1,20 @@
+#pragma once
+
+// OpenGL 3.3 core context without a window or display server.
+// Uses EGL on the Mesa surfaceless platform (works with llvmpipe), Linux only.
+class HeadlessContext
+{
+    private:
+        void* m_Display;
+        void* m_Context;
+    public:
+        // A debug context reports more through EnableGLDebugOutput
+        HeadlessContext(bool debug = false);
+        ~HeadlessContext();
+
+        HeadlessContext(const HeadlessContext&) = delete;
+        HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+        // True once the context is current and glad has loaded
+        inline bool IsValid() const { return m_Context != nullptr; }
+};
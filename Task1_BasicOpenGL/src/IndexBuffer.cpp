@@ -1,26 +1,42 @@
 #include <IndexBuffer.h>
+#include <RenderStats.h>
 
 IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int size)
-    : m_Count(size / sizeof(unsigned int))
+    : m_Count(size / sizeof(unsigned int)), m_Type(GL_UNSIGNED_INT)
 {
     ASSERT(sizeof(unsigned int) == sizeof(GLuint));
 
     GLCall(glGenBuffers(1, &m_RendererID));
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+    Bind();
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+    RenderStats::CountBufferUpload(size);
+}
+
+IndexBuffer::IndexBuffer(const unsigned short* data, unsigned int size)
+    : m_Count(size / sizeof(unsigned short)), m_Type(GL_UNSIGNED_SHORT)
+{
+    ASSERT(sizeof(unsigned short) == sizeof(GLushort));
+
+    GLCall(glGenBuffers(1, &m_RendererID));
+    Bind();
     GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+    RenderStats::CountBufferUpload(size);
 }
 
 IndexBuffer::~IndexBuffer()
 {
+    RenderStats::CountDelete(BindTarget::ElementBuffer, m_RendererID);
     GLCall(glDeleteBuffers(1, &m_RendererID));
 }
 
 void IndexBuffer::Bind() const
 {
+    RenderStats::CountBind(BindTarget::ElementBuffer, m_RendererID);
     GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
 }
 
 void IndexBuffer::Unbind() const
 {
+    RenderStats::CountBind(BindTarget::ElementBuffer, 0);
     GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 }
\ No newline at end of file
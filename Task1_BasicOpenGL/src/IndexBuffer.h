@@ -8,12 +8,16 @@ class IndexBuffer
     private:
         unsigned int m_RendererID;
         unsigned int m_Count;
+        unsigned int m_Type;
     public:
         IndexBuffer(const unsigned int* data, unsigned int size);
+        IndexBuffer(const unsigned short* data, unsigned int size);
         ~IndexBuffer();
 
         void Bind() const;
         void Unbind() const;
 
         inline unsigned int GetCount() const { return m_Count; }
+        // GL_UNSIGNED_INT or GL_UNSIGNED_SHORT, pass to glDrawElements
+        inline unsigned int GetType() const { return m_Type; }
 };
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "InputLog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+static const char MAGIC[4] = { 'R', 'I', 'N', 'P' };
+static const uint16_t VERSION = 1;
+static const size_t HEADER_SIZE = 12;
+static const size_t EVENT_SIZE = 20;
+
+// Fields are copied as they are, every platform we build for is little-endian
+static void WriteHeader(std::FILE* file, uint32_t count)
+{
+    unsigned char header[HEADER_SIZE] = {};
+    std::memcpy(header, MAGIC, 4);
+    std::memcpy(header + 4, &VERSION, 2);
+    std::memcpy(header + 8, &count, 4);
+
+    std::fseek(file, 0, SEEK_SET);
+    std::fwrite(header, 1, HEADER_SIZE, file);
+}
+
+InputRecorder::InputRecorder(const std::string& filepath)
+    : m_File(std::fopen(filepath.c_str(), "wb")), m_Count(0), m_LastMicros(0)
+{
+    // Rewritten with the count on Close
+    if (m_File)
+        WriteHeader(m_File, 0);
+}
+
+InputRecorder::~InputRecorder()
+{
+    Close();
+}
+
+void InputRecorder::Record(const InputEvent& event)
+{
+    if (!m_File)
+        return;
+
+    uint64_t micros = (uint64_t)std::llround(std::max(0.0, event.time) * 1e6);
+    uint32_t delta = (uint32_t)std::min<uint64_t>(micros > m_LastMicros ? micros - m_LastMicros : 0, UINT32_MAX);
+    m_LastMicros += delta;
+
+    unsigned char record[EVENT_SIZE];
+    uint16_t mods = (uint16_t)event.mods;
+    int32_t code = event.code;
+    float x = (float)event.x, y = (float)event.y;
+    record[0] = (unsigned char)event.type;
+    record[1] = (unsigned char)event.action;
+    std::memcpy(record + 2, &mods, 2);
+    std::memcpy(record + 4, &code, 4);
+    std::memcpy(record + 8, &delta, 4);
+    std::memcpy(record + 12, &x, 4);
+    std::memcpy(record + 16, &y, 4);
+
+    std::fwrite(record, 1, EVENT_SIZE, m_File);
+    m_Count++;
+}
+
+bool InputRecorder::Close()
+{
+    if (!m_File)
+        return false;
+
+    WriteHeader(m_File, m_Count);
+    bool ok = !std::ferror(m_File);
+    ok = std::fclose(m_File) == 0 && ok;
+    m_File = nullptr;
+    return ok;
+}
+
+InputReplay::InputReplay(const std::string& filepath)
+    : m_Next(0)
+{
+    std::ifstream stream(filepath, std::ios::binary);
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    uint16_t version = 0;
+    uint32_t count = 0;
+    if (data.size() < HEADER_SIZE || std::memcmp(data.data(), MAGIC, 4) != 0)
+    {
+        m_Error = stream ? "not an input log" : "cannot open file";
+        return;
+    }
+    std::memcpy(&version, data.data() + 4, 2);
+    std::memcpy(&count, data.data() + 8, 4);
+    if (version != VERSION)
+    {
+        m_Error = "unsupported version " + std::to_string(version);
+        return;
+    }
+    if ((data.size() - HEADER_SIZE) / EVENT_SIZE < count)
+    {
+        m_Error = "truncated file";
+        return;
+    }
+
+    // Summed in integer microseconds, so the times are the same on every read
+    uint64_t micros = 0;
+    m_Events.resize(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const unsigned char* record = data.data() + HEADER_SIZE + (size_t)i * EVENT_SIZE;
+        InputEvent& event = m_Events[i];
+
+        uint16_t mods;
+        int32_t code;
+        uint32_t delta;
+        float x, y;
+        std::memcpy(&mods, record + 2, 2);
+        std::memcpy(&code, record + 4, 4);
+        std::memcpy(&delta, record + 8, 4);
+        std::memcpy(&x, record + 12, 4);
+        std::memcpy(&y, record + 16, 4);
+
+        micros += delta;
+        event.time = micros * 1e-6;
+        event.type = (InputEventType)record[0];
+        event.action = record[1];
+        event.mods = mods;
+        event.code = code;
+        event.x = x;
+        event.y = y;
+    }
+}
+
+bool InputReplay::Next(double time, InputEvent& event)
+{
+    if (m_Next >= m_Events.size() || m_Events[m_Next].time > time)
+        return false;
+
+    event = m_Events[m_Next++];
+    return true;
+}
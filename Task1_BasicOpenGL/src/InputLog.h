@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Window input in the form the GLFW callbacks get it
+enum class InputEventType : uint8_t
+{
+    Key = 1,         // code = key, action, mods
+    CursorPos,       // x, y
+    MouseButton,     // code = button, action, mods
+    Scroll,          // x, y = offsets
+    FramebufferSize  // x, y = width, height
+};
+
+struct InputEvent
+{
+    double time = 0.0; // seconds since the recording started
+    InputEventType type = InputEventType::Key;
+    int code = 0;
+    int action = 0;
+    int mods = 0;
+    double x = 0.0, y = 0.0;
+};
+
+// Input log file (little-endian): "RINP", u16 version, u16 reserved, u32 event
+// count, then 20 bytes per event: u8 type, u8 action, u16 mods, i32 code,
+// u32 microseconds since the previous event, f32 x, f32 y.
+class InputRecorder
+{
+    private:
+        std::FILE* m_File;
+        uint32_t m_Count;
+        uint64_t m_LastMicros;
+    public:
+        InputRecorder(const std::string& filepath);
+        ~InputRecorder();
+
+        InputRecorder(const InputRecorder&) = delete;
+        InputRecorder& operator=(const InputRecorder&) = delete;
+
+        // Events have to come in time order
+        void Record(const InputEvent& event);
+        // Fills in the count, false if anything failed to write
+        bool Close();
+
+        inline bool IsValid() const { return m_File != nullptr; }
+        inline uint32_t GetCount() const { return m_Count; }
+};
+
+// Whole log read up front, handed out as the replay clock passes each event
+class InputReplay
+{
+    private:
+        std::vector<InputEvent> m_Events;
+        size_t m_Next;
+        std::string m_Error;
+    public:
+        InputReplay(const std::string& filepath);
+
+        // Next event at or before time, false if there is none yet
+        bool Next(double time, InputEvent& event);
+
+        inline bool IsValid() const { return m_Error.empty(); }
+        inline const std::string& GetError() const { return m_Error; }
+        inline bool IsFinished() const { return m_Next >= m_Events.size(); }
+        inline size_t GetCount() const { return m_Events.size(); }
+        inline double GetDuration() const { return m_Events.empty() ? 0.0 : m_Events.back().time; }
+};
@@ -0,0 +1,214 @@
+#include <KtxImage.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+// KTX2 files are little-endian, and so is every platform we build for,
+// so header fields are copied straight out of the file.
+
+static const unsigned char KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+static const size_t HEADER_SIZE = 80;
+static const size_t LEVEL_INDEX_SIZE = 24;
+
+static bool Fail(std::string* error, const std::string& message)
+{
+    if (error)
+        *error = message;
+    return false;
+}
+
+template<typename T>
+static T Read(const std::vector<unsigned char>& file, size_t offset)
+{
+    T value;
+    std::memcpy(&value, file.data() + offset, sizeof(T));
+    return value;
+}
+
+template<typename T>
+static void Write(std::vector<unsigned char>& file, size_t offset, T value)
+{
+    std::memcpy(file.data() + offset, &value, sizeof(T));
+}
+
+int KtxImage::GetBlockSize(KtxFormat format)
+{
+    switch (format)
+    {
+    case KtxFormat::BC1_RGB:
+    case KtxFormat::BC1_RGBA:
+    case KtxFormat::ETC2_RGB:
+        return 8;
+    case KtxFormat::BC3_RGBA:
+    case KtxFormat::BC7_RGBA:
+    case KtxFormat::ETC2_RGBA:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+size_t KtxImage::GetLevelSize(KtxFormat format, int width, int height)
+{
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+}
+
+void KtxImage::AddLevel(const unsigned char* blocks)
+{
+    KtxLevel level;
+    level.width = std::max(1, width >> (int)levels.size());
+    level.height = std::max(1, height >> (int)levels.size());
+    level.offset = data.size();
+    level.size = GetLevelSize(format, level.width, level.height);
+
+    data.insert(data.end(), blocks, blocks + level.size);
+    levels.push_back(level);
+}
+
+bool LoadKtx2(const std::string& filepath, KtxImage& image, std::string* error)
+{
+    std::ifstream stream(filepath, std::ios::binary);
+    if (!stream)
+        return Fail(error, "cannot open file");
+
+    std::vector<unsigned char> file((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    if (file.size() < HEADER_SIZE || std::memcmp(file.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+        return Fail(error, "not a KTX2 file");
+
+    KtxFormat format = (KtxFormat)Read<uint32_t>(file, 12);
+    uint32_t width = Read<uint32_t>(file, 20);
+    uint32_t height = Read<uint32_t>(file, 24);
+    uint32_t depth = Read<uint32_t>(file, 28);
+    uint32_t layers = Read<uint32_t>(file, 32);
+    uint32_t faces = Read<uint32_t>(file, 36);
+    uint32_t levelCount = std::max(1u, Read<uint32_t>(file, 40));
+    uint32_t supercompression = Read<uint32_t>(file, 44);
+
+    if (KtxImage::GetBlockSize(format) == 0)
+        return Fail(error, "unsupported format " + std::to_string((uint32_t)format));
+    if (depth != 0 || layers != 0 || faces != 1 || width == 0 || height == 0)
+        return Fail(error, "only single 2D textures are supported");
+    if (supercompression != 0)
+        return Fail(error, "supercompressed files are not supported");
+    if (levelCount > 32 || file.size() < HEADER_SIZE + levelCount * LEVEL_INDEX_SIZE)
+        return Fail(error, "truncated level index");
+
+    image = KtxImage();
+    image.format = format;
+    image.width = (int)width;
+    image.height = (int)height;
+
+    for (uint32_t i = 0; i < levelCount; i++)
+    {
+        size_t entry = HEADER_SIZE + i * LEVEL_INDEX_SIZE;
+        uint64_t offset = Read<uint64_t>(file, entry);
+        uint64_t size = Read<uint64_t>(file, entry + 8);
+
+        int levelWidth = std::max(1, image.width >> i);
+        int levelHeight = std::max(1, image.height >> i);
+        if (size != KtxImage::GetLevelSize(format, levelWidth, levelHeight) || offset > file.size() || size > file.size() - offset)
+            return Fail(error, "bad size for level " + std::to_string(i));
+
+        image.AddLevel(file.data() + offset);
+    }
+
+    return true;
+}
+
+// Data Format Descriptor with one basic block, see the Khronos Data Format spec
+static std::vector<unsigned char> MakeDescriptor(KtxFormat format)
+{
+    struct Sample { uint8_t channel; uint16_t bitOffset; uint8_t bitLength; };
+
+    uint8_t colorModel = 0;
+    std::vector<Sample> samples;
+    switch (format)
+    {
+    case KtxFormat::BC1_RGB:   colorModel = 128; samples = { { 0, 0, 64 } }; break;
+    case KtxFormat::BC1_RGBA:  colorModel = 128; samples = { { 15, 0, 64 } }; break;
+    case KtxFormat::BC3_RGBA:  colorModel = 130; samples = { { 15, 0, 64 }, { 0, 64, 64 } }; break;
+    case KtxFormat::BC7_RGBA:  colorModel = 134; samples = { { 0, 0, 128 } }; break;
+    case KtxFormat::ETC2_RGB:  colorModel = 161; samples = { { 2, 0, 64 } }; break;
+    case KtxFormat::ETC2_RGBA: colorModel = 161; samples = { { 15, 0, 64 }, { 2, 64, 64 } }; break;
+    default: break;
+    }
+
+    uint16_t blockSize = (uint16_t)(24 + 16 * samples.size());
+    std::vector<unsigned char> dfd(4 + blockSize, 0);
+    Write<uint32_t>(dfd, 0, (uint32_t)dfd.size());
+    Write<uint32_t>(dfd, 4, 0);          // vendor Khronos, descriptor type basic
+    Write<uint16_t>(dfd, 8, 2);          // version 1.3
+    Write<uint16_t>(dfd, 10, blockSize);
+    dfd[12] = colorModel;
+    dfd[13] = 1;                         // BT.709 primaries
+    dfd[14] = 1;                         // linear transfer
+    dfd[15] = 0;                         // straight alpha
+    dfd[16] = 3;                         // 4x4x1x1 texel block
+    dfd[17] = 3;
+    dfd[20] = (unsigned char)KtxImage::GetBlockSize(format);
+
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        size_t base = 28 + 16 * i;
+        Write<uint16_t>(dfd, base, samples[i].bitOffset);
+        dfd[base + 2] = samples[i].bitLength - 1;
+        dfd[base + 3] = samples[i].channel;
+        Write<uint32_t>(dfd, base + 8, 0);           // sampleLower
+        Write<uint32_t>(dfd, base + 12, 0xFFFFFFFFu); // sampleUpper
+    }
+    return dfd;
+}
+
+bool SaveKtx2(const std::string& filepath, const KtxImage& image, std::string* error)
+{
+    int blockSize = KtxImage::GetBlockSize(image.format);
+    if (blockSize == 0 || image.levels.empty())
+        return Fail(error, "nothing to write");
+
+    std::vector<unsigned char> dfd = MakeDescriptor(image.format);
+
+    // One key/value pair, padded to 4 bytes
+    const char orientation[] = "KTXorientation\0ru";
+    std::vector<unsigned char> kvd(4 + ((sizeof(orientation) + 3) & ~3u), 0);
+    Write<uint32_t>(kvd, 0, (uint32_t)sizeof(orientation));
+    std::memcpy(kvd.data() + 4, orientation, sizeof(orientation));
+
+    size_t levelCount = image.levels.size();
+    size_t dfdOffset = HEADER_SIZE + levelCount * LEVEL_INDEX_SIZE;
+    size_t kvdOffset = dfdOffset + dfd.size();
+
+    std::vector<unsigned char> file(kvdOffset + kvd.size(), 0);
+    std::memcpy(file.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+    Write<uint32_t>(file, 12, (uint32_t)image.format);
+    Write<uint32_t>(file, 16, 1);        // typeSize, 1 for block-compressed formats
+    Write<uint32_t>(file, 20, (uint32_t)image.width);
+    Write<uint32_t>(file, 24, (uint32_t)image.height);
+    Write<uint32_t>(file, 36, 1);        // faceCount
+    Write<uint32_t>(file, 40, (uint32_t)levelCount);
+    Write<uint32_t>(file, 48, (uint32_t)dfdOffset);
+    Write<uint32_t>(file, 52, (uint32_t)dfd.size());
+    Write<uint32_t>(file, 56, (uint32_t)kvdOffset);
+    Write<uint32_t>(file, 60, (uint32_t)kvd.size());
+    std::memcpy(file.data() + dfdOffset, dfd.data(), dfd.size());
+    std::memcpy(file.data() + kvdOffset, kvd.data(), kvd.size());
+
+    // The spec stores the smallest level first, each aligned to the block size
+    for (size_t i = levelCount; i-- > 0;)
+    {
+        const KtxLevel& level = image.levels[i];
+        file.resize((file.size() + blockSize - 1) / blockSize * blockSize, 0);
+
+        size_t entry = HEADER_SIZE + i * LEVEL_INDEX_SIZE;
+        Write<uint64_t>(file, entry, file.size());
+        Write<uint64_t>(file, entry + 8, level.size);
+        Write<uint64_t>(file, entry + 16, level.size);
+
+        file.insert(file.end(), image.data.begin() + level.offset, image.data.begin() + level.offset + level.size);
+    }
+
+    std::ofstream stream(filepath, std::ios::binary);
+    if (!stream.write((const char*)file.data(), file.size()))
+        return Fail(error, "cannot write file");
+    return true;
+}
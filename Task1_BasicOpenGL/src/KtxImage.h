@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// VkFormat values of the block-compressed payloads we read and write (KTX2 stores Vulkan formats)
+enum class KtxFormat : uint32_t
+{
+    Undefined = 0,
+    BC1_RGB   = 131, // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+    BC1_RGBA  = 133, // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+    BC3_RGBA  = 137, // VK_FORMAT_BC3_UNORM_BLOCK
+    BC7_RGBA  = 145, // VK_FORMAT_BC7_UNORM_BLOCK
+    ETC2_RGB  = 147, // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+    ETC2_RGBA = 151  // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+};
+
+struct KtxLevel
+{
+    int width = 0, height = 0;
+    size_t offset = 0, size = 0; // into KtxImage::data
+};
+
+// A single 2D texture in a KTX2 container: 4x4 block-compressed, no
+// supercompression, mip levels largest first. Rows are stored bottom-up
+// (KTXorientation "ru") so the data uploads like a flipped stbi image.
+struct KtxImage
+{
+    KtxFormat format = KtxFormat::Undefined;
+    int width = 0, height = 0;
+    std::vector<KtxLevel> levels;
+    std::vector<unsigned char> data; // all levels back to back
+
+    // Bytes per 4x4 block, 0 for unknown formats
+    static int GetBlockSize(KtxFormat format);
+    static size_t GetLevelSize(KtxFormat format, int width, int height);
+
+    // Appends a level of the next smaller size, data must be GetLevelSize bytes
+    void AddLevel(const unsigned char* blocks);
+};
+
+// Both return false and fill error (if given) on failure
+bool LoadKtx2(const std::string& filepath, KtxImage& image, std::string* error = nullptr);
+bool SaveKtx2(const std::string& filepath, const KtxImage& image, std::string* error = nullptr);
@@ -0,0 +1,111 @@
+#include "Move.h"
+
+#include <cctype>
+#include <sstream>
+
+// Face letter -> axis, which end of the axis the depth counts from and the
+// quarter-turn sign of a clockwise turn seen from that face
+struct FaceInfo
+{
+    char letter;
+    int axis;
+    bool fromPositive;
+    int clockwise;
+};
+
+static const FaceInfo FACES[] = {
+    { 'R', 0, true,  -1 },
+    { 'L', 0, false,  1 },
+    { 'U', 1, true,  -1 },
+    { 'D', 1, false,  1 },
+    { 'F', 2, true,  -1 },
+    { 'B', 2, false,  1 },
+    // Middle layers follow L, D and F
+    { 'M', 0, false,  1 },
+    { 'E', 1, false,  1 },
+    { 'S', 2, true,  -1 },
+};
+
+glm::vec3 Move::GetAxisVector() const
+{
+    glm::vec3 v(0.0f);
+    v[axis] = 1.0f;
+    return v;
+}
+
+static const FaceInfo* FindFace(char letter)
+{
+    for (const auto& face : FACES)
+        if (face.letter == letter) return &face;
+    return nullptr;
+}
+
+bool ParseMoves(const std::string& text, int cubeSize, std::vector<Move>& moves, std::string* error)
+{
+    std::istringstream stream(text);
+    std::string token;
+
+    while (stream >> token)
+    {
+        size_t i = 0;
+        int depth = 1;
+        if (std::isdigit((unsigned char)token[0]))
+        {
+            depth = 0;
+            while (i < token.size() && std::isdigit((unsigned char)token[i]))
+                depth = depth * 10 + (token[i++] - '0');
+        }
+
+        const FaceInfo* face = (i < token.size()) ? FindFace(token[i]) : nullptr;
+        bool middle = face && (face->letter == 'M' || face->letter == 'E' || face->letter == 'S');
+        if (!face || depth < 1 || depth > cubeSize || (middle && (depth != 1 || cubeSize % 2 == 0)))
+        {
+            if (error) *error = "invalid move '" + token + "'";
+            return false;
+        }
+        i++;
+
+        int amount = 1;
+        if (i < token.size() && token[i] == '2') { amount = 2; i++; }
+        if (i < token.size() && token[i] == '\'') { amount = -amount; i++; }
+        if (i != token.size())
+        {
+            if (error) *error = "invalid move '" + token + "'";
+            return false;
+        }
+
+        Move move;
+        move.axis = face->axis;
+        if (middle)
+            move.layer = cubeSize / 2;
+        else
+            move.layer = face->fromPositive ? cubeSize - depth : depth - 1;
+        move.quarterTurns = face->clockwise * amount;
+        moves.push_back(move);
+    }
+
+    return true;
+}
+
+std::string MoveToString(const Move& move, int cubeSize)
+{
+    // Name the move after the nearer face
+    bool fromPositive = move.layer >= cubeSize - 1 - move.layer;
+    const FaceInfo* face = nullptr;
+    for (const auto& f : FACES)
+        if (f.axis == move.axis && f.fromPositive == fromPositive && f.letter != 'M' && f.letter != 'E' && f.letter != 'S')
+            face = &f;
+
+    int depth = fromPositive ? cubeSize - move.layer : move.layer + 1;
+    int turns = ((move.quarterTurns * face->clockwise) % 4 + 4) % 4; // clockwise quarter turns
+
+    std::string result;
+    if (turns == 0)
+        return result;
+    if (depth > 1)
+        result += std::to_string(depth);
+    result += face->letter;
+    if (turns == 2) result += "2";
+    else if (turns == 3) result += "'";
+    return result;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+// A single layer turn, independent of how it is animated
+struct Move
+{
+    int axis = 0;         // 0 = X, 1 = Y, 2 = Z
+    int layer = 0;        // index along the axis, 0 .. size - 1
+    int quarterTurns = 1; // signed, counter-clockwise about +axis (right-hand rule)
+
+    // Angle as passed to RubiksCube::FinishTurn together with AxisVector
+    float GetDegrees() const { return 90.0f * quarterTurns; }
+    glm::vec3 GetAxisVector() const;
+};
+
+// Parses standard notation separated by whitespace: U D L R F B (outer layers),
+// M E S (middle layers, odd sizes), an optional depth prefix for inner layers
+// of big cubes ("2R" = second layer from the right) and the ' and 2 suffixes.
+// Returns false and fills error on the first invalid token.
+bool ParseMoves(const std::string& text, int cubeSize, std::vector<Move>& moves, std::string* error = nullptr);
+
+// Inverse of ParseMoves for a single move
+std::string MoveToString(const Move& move, int cubeSize);
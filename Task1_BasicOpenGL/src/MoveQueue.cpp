@@ -0,0 +1,200 @@
+#include "MoveQueue.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+MoveQueue::MoveQueue(float degreesPerSecond, float maxBacklogSeconds, float maxSpeedup)
+    : m_CubeSize(0), m_Backlog(0.0f), m_Speed(degreesPerSecond), m_MaxBacklog(maxBacklogSeconds),
+      m_MaxSpeedup(maxSpeedup)
+{
+}
+
+// The same turn in notation form. Keys turn about negative axes too, and layer -1
+// means the outer layer on the axis' side, as in RubiksCube::IsInTurningLayer.
+static Move ToMove(const QueuedTurn& turn, int cubeSize)
+{
+    glm::vec3 a = glm::abs(turn.axis);
+    Move move;
+    move.axis = (a.x >= a.y && a.x >= a.z) ? 0 : (a.y >= a.z ? 1 : 2);
+
+    float sign = turn.axis[move.axis] < 0.0f ? -1.0f : 1.0f;
+    move.quarterTurns = (int)std::lround(sign * turn.degrees / 90.0f);
+    move.layer = turn.layer >= 0 ? turn.layer : (sign > 0.0f ? cubeSize - 1 : 0);
+    return move;
+}
+
+void MoveQueue::Push(const QueuedTurn& turn)
+{
+    if (turn.degrees == 0.0f)
+        return;
+
+    Entry entry;
+    entry.turn = turn;
+    Resolve(entry);
+    m_Turns.push_back(entry);
+}
+
+void MoveQueue::Push(const Move& move)
+{
+    Push(QueuedTurn{ move.GetAxisVector(), move.GetDegrees(), move.layer });
+}
+
+void MoveQueue::Clear()
+{
+    m_Turns.clear();
+    m_Active.clear();
+    m_Animating.clear();
+    m_Backlog = 0.0f;
+}
+
+void MoveQueue::Resolve(Entry& entry) const
+{
+    Move move = ToMove(entry.turn, m_CubeSize);
+    entry.axis = move.axis;
+    entry.layer = std::min(std::max(move.layer, 0), std::max(m_CubeSize - 1, 0));
+}
+
+void MoveQueue::FindActive()
+{
+    m_Active.clear();
+    if (m_Turns.empty())
+        return;
+
+    int axis = m_Turns.front().axis;
+    for (size_t i = 0; i < m_Turns.size() && m_Turns[i].axis == axis && (int)m_Active.size() < m_CubeSize; i++)
+    {
+        bool blocked = false;
+        for (size_t active : m_Active)
+            blocked = blocked || m_Turns[active].layer == m_Turns[i].layer;
+        if (!blocked)
+            m_Active.push_back(i);
+    }
+}
+
+float MoveQueue::GetBacklogDegrees(float keepDegrees, size_t& skipCount)
+{
+    // From the newest turn back: runs on one axis take as long as their busiest
+    // layer, runs on different axes play one after another
+    m_LayerTimes.assign(m_CubeSize, 0.0f);
+    float done = 0.0f; // later runs
+    float run = 0.0f;
+    int axis = -1;
+    skipCount = 0;
+
+    for (size_t i = m_Turns.size(); i-- > 0;)
+    {
+        const Entry& entry = m_Turns[i];
+        if (entry.axis != axis)
+        {
+            done += run;
+            run = 0.0f;
+            axis = entry.axis;
+            std::fill(m_LayerTimes.begin(), m_LayerTimes.end(), 0.0f);
+        }
+
+        float& layerTime = m_LayerTimes[entry.layer];
+        layerTime += std::abs(entry.turn.degrees) - entry.progress;
+        run = std::max(run, layerTime);
+
+        if (skipCount == 0 && done + run > keepDegrees)
+            skipCount = i + 1;
+    }
+    return done + run;
+}
+
+void MoveQueue::Update(RubiksCube& cube, float deltaTime)
+{
+    PROFILE_SCOPE("MoveQueue::Update");
+    // Layers are resolved against the cube they turn
+    if (cube.GetSize() != m_CubeSize)
+    {
+        m_CubeSize = cube.GetSize();
+        for (auto& entry : m_Turns)
+            Resolve(entry);
+    }
+
+    m_Animating.clear();
+    if (m_Turns.empty())
+    {
+        m_Backlog = 0.0f;
+        return;
+    }
+
+    // More than the budget can show even sped up: drop the animation of the oldest turns
+    size_t skipCount;
+    float keep = m_Speed * m_MaxBacklog * m_MaxSpeedup;
+    m_Backlog = GetBacklogDegrees(keep, skipCount);
+    if (skipCount > 0)
+    {
+        SkipTurns(cube, skipCount);
+        m_Backlog = GetBacklogDegrees(keep, skipCount);
+    }
+
+    // Play a long backlog within the budget instead of at the normal speed
+    float speed = std::max(m_Speed, m_Backlog / m_MaxBacklog);
+    float advance = speed * deltaTime;
+
+    // Step to the next turn that ends, so the ones waiting behind it start in
+    // the same frame with what is left
+    while (advance > 0.0f && !m_Turns.empty())
+    {
+        FindActive();
+
+        float step = advance;
+        for (size_t i : m_Active)
+            step = std::min(step, std::abs(m_Turns[i].turn.degrees) - m_Turns[i].progress);
+
+        for (size_t i : m_Active)
+        {
+            Entry& entry = m_Turns[i];
+            float left = std::abs(entry.turn.degrees) - entry.progress;
+            entry.progress = left <= step ? std::abs(entry.turn.degrees) : entry.progress + step;
+        }
+        advance -= step;
+
+        // Indices go up, erase from the back so the others stay valid
+        for (size_t n = m_Active.size(); n-- > 0;)
+        {
+            const Entry& entry = m_Turns[m_Active[n]];
+            if (entry.progress < std::abs(entry.turn.degrees))
+                continue;
+
+            cube.FinishTurn(entry.turn.axis, entry.turn.degrees, entry.turn.layer);
+            m_Turns.erase(m_Turns.begin() + m_Active[n]);
+        }
+        m_Backlog = std::max(0.0f, m_Backlog - step);
+    }
+
+    FindActive();
+    for (size_t i : m_Active)
+    {
+        const Entry& entry = m_Turns[i];
+        float angle = entry.turn.degrees < 0.0f ? -entry.progress : entry.progress;
+        m_Animating.push_back(LayerTurn{ entry.turn.axis, angle, entry.turn.layer });
+    }
+}
+
+void MoveQueue::SkipTurns(RubiksCube& cube, size_t count)
+{
+    PROFILE_SCOPE("MoveQueue::SkipTurns");
+    // Integer turns on a CubeState, the cube itself is only rebuilt once.
+    // Cubies moved by hand go back to their grid slots.
+    bool applied = false;
+    if (m_CubeSize <= MAX_STATE_CUBE_SIZE)
+    {
+        CubeState state;
+        cube.GetState(state);
+        for (size_t i = 0; i < count; i++)
+            state.ApplyMove(ToMove(m_Turns[i].turn, m_CubeSize));
+        applied = cube.SetState(state);
+    }
+
+    // Otherwise turn by turn on the cube itself
+    if (!applied)
+    {
+        for (size_t i = 0; i < count; i++)
+            cube.ApplyMove(ToMove(m_Turns[i].turn, m_CubeSize));
+    }
+    m_Turns.erase(m_Turns.begin(), m_Turns.begin() + count);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Move.h"
+#include "RubiksCube.h"
+
+#include <deque>
+#include <vector>
+#include <glm/glm.hpp>
+
+// A layer turn as animated by the app, same parameters as RubiksCube::FinishTurn
+struct QueuedTurn
+{
+    glm::vec3 axis = glm::vec3(0.0f);
+    float degrees = 0.0f; // signed
+    int layer = -1;
+};
+
+// Turns waiting to be animated, played in order so none is dropped while
+// another one is turning. Turns of different layers on the same axis share no
+// cubies, so they animate at the same time; a turn only waits for earlier ones
+// it conflicts with.
+// A backlog of more than maxBacklog seconds plays faster to catch up within
+// that time, up to maxSpeedup; turns that still would not fit are applied at
+// once, in one batch on a CubeState, without being shown.
+class MoveQueue
+{
+    private:
+        struct Entry
+        {
+            QueuedTurn turn;
+            float progress = 0.0f; // degrees already done
+            int axis = 0;          // grid axis and layer, resolved for the cube size
+            int layer = 0;
+        };
+
+        std::deque<Entry> m_Turns;
+        std::vector<size_t> m_Active;  // indices into m_Turns, filled by FindActive
+        std::vector<LayerTurn> m_Animating;
+        std::vector<float> m_LayerTimes; // scratch for GetBacklogDegrees
+        int m_CubeSize;
+        float m_Backlog;                 // degrees of animation left, as of the last Update
+        float m_Speed;
+        float m_MaxBacklog;
+        float m_MaxSpeedup;
+
+        void Resolve(Entry& entry) const;
+        // The turns that may animate now: the first turn of each layer, up to the
+        // first turn on another axis
+        void FindActive();
+        // Time left at normal speed in degrees, and how many of the oldest turns
+        // have to go for the rest to fit in keepDegrees
+        float GetBacklogDegrees(float keepDegrees, size_t& skipCount);
+        void SkipTurns(RubiksCube& cube, size_t count);
+    public:
+        MoveQueue(float degreesPerSecond = 180.0f, float maxBacklogSeconds = 1.0f, float maxSpeedup = 4.0f);
+
+        void Push(const QueuedTurn& turn);
+        void Push(const Move& move);
+        // Drops everything, turns in progress snap back
+        void Clear();
+
+        // Advances the animation, applying every turn that completes to the cube
+        void Update(RubiksCube& cube, float deltaTime);
+
+        inline bool IsTurning() const { return !m_Turns.empty(); }
+        // Layers in progress with their angles so far, as passed to RubiksCube::Draw
+        inline const std::vector<LayerTurn>& GetTurns() const { return m_Animating; }
+
+        inline size_t GetQueuedCount() const { return m_Turns.size(); }
+        inline float GetSpeed() const { return m_Speed; }
+        // Time left at normal speed, as of the last Update
+        inline float GetBacklogSeconds() const { return m_Backlog / m_Speed; }
+};
@@ -0,0 +1,199 @@
+#include "PerfOverlay.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+// Pixel sizes
+static const float FONT_SCALE = 2.0f; // screen pixels per font pixel
+static const float CHAR_ADVANCE = 4.0f * FONT_SCALE;
+static const float LINE_HEIGHT = 7.0f * FONT_SCALE;
+static const float MARGIN = 8.0f;
+static const float PADDING = 8.0f;
+static const int HISTORY_LENGTH = 120;
+static const float BAR_WIDTH = 2.0f;
+static const float GRAPH_HEIGHT = 32.0f;
+static const float GRAPH_MAX_MS = 1000.0f / 30.0f; // top of the graphs, the 60 Hz budget is halfway
+
+// Colors, RGBA
+static const unsigned int PANEL_COLOR = 0x000000B0;
+static const unsigned int TEXT_COLOR = 0xFFFFFFFF;
+static const unsigned int CPU_COLOR = 0x66FF66FF;
+static const unsigned int GPU_COLOR = 0xFFAA33FF;
+static const unsigned int BUDGET_COLOR = 0xFFFFFF60;
+
+// 3x5 pixel font, one row per byte from the top, bit 2 = left column
+struct Glyph
+{
+    char character;
+    unsigned char rows[5];
+};
+
+static const Glyph FONT[] = {
+    { '0', { 7, 5, 5, 5, 7 } }, { '1', { 2, 6, 2, 2, 7 } }, { '2', { 7, 1, 7, 4, 7 } }, { '3', { 7, 1, 7, 1, 7 } },
+    { '4', { 5, 5, 7, 1, 1 } }, { '5', { 7, 4, 7, 1, 7 } }, { '6', { 7, 4, 7, 5, 7 } }, { '7', { 7, 1, 1, 1, 1 } },
+    { '8', { 7, 5, 7, 5, 7 } }, { '9', { 7, 5, 7, 1, 7 } }, { '.', { 0, 0, 0, 0, 2 } }, { ':', { 0, 2, 0, 2, 0 } },
+    { '/', { 1, 1, 2, 4, 4 } }, { '-', { 0, 0, 7, 0, 0 } },
+    { 'A', { 2, 5, 7, 5, 5 } }, { 'B', { 6, 5, 6, 5, 6 } }, { 'C', { 3, 4, 4, 4, 3 } }, { 'D', { 6, 5, 5, 5, 6 } },
+    { 'E', { 7, 4, 6, 4, 7 } }, { 'F', { 7, 4, 6, 4, 4 } }, { 'G', { 3, 4, 5, 5, 3 } }, { 'H', { 5, 5, 7, 5, 5 } },
+    { 'I', { 7, 2, 2, 2, 7 } }, { 'K', { 5, 5, 6, 5, 5 } }, { 'L', { 4, 4, 4, 4, 7 } }, { 'M', { 5, 7, 7, 5, 5 } },
+    { 'N', { 6, 5, 5, 5, 5 } }, { 'O', { 2, 5, 5, 5, 2 } }, { 'P', { 6, 5, 6, 4, 4 } }, { 'R', { 6, 5, 6, 5, 5 } },
+    { 'S', { 3, 4, 2, 1, 6 } }, { 'T', { 7, 2, 2, 2, 2 } }, { 'U', { 5, 5, 5, 5, 7 } }, { 'W', { 5, 5, 7, 7, 5 } },
+};
+
+static const Glyph* FindGlyph(char character)
+{
+    for (const Glyph& glyph : FONT)
+    {
+        if (glyph.character == character)
+            return &glyph;
+    }
+    return nullptr;
+}
+
+PerfOverlay::PerfOverlay()
+    : m_Shader(new Shader("res/shaders/overlay.shader")), m_VBO(new VertexBuffer(4096 * sizeof(Vertex))),
+      m_VAO(new VertexArray()), m_CpuHistory(HISTORY_LENGTH, 0.0f), m_GpuHistory(HISTORY_LENGTH, 0.0f), m_HistoryPos(0)
+{
+    m_ScreenSize = m_Shader->GetUniformHandle("u_ScreenSize");
+
+    VertexBufferLayout layout;
+    layout.Push<float>(2);         // position
+    layout.Push<unsigned char>(4); // color
+    m_VAO->AddBuffer(*m_VBO, layout);
+    m_VAO->Unbind();
+}
+
+PerfOverlay::~PerfOverlay()
+{
+    delete m_VAO;
+    delete m_VBO;
+    delete m_Shader;
+}
+
+void PerfOverlay::AddRect(float x, float y, float width, float height, unsigned int color)
+{
+    Vertex corner[4];
+    float xs[4] = { x, x + width, x + width, x };
+    float ys[4] = { y, y, y + height, y + height };
+    for (int i = 0; i < 4; i++)
+    {
+        corner[i].position[0] = xs[i];
+        corner[i].position[1] = ys[i];
+        corner[i].color[0] = (unsigned char)(color >> 24);
+        corner[i].color[1] = (unsigned char)(color >> 16);
+        corner[i].color[2] = (unsigned char)(color >> 8);
+        corner[i].color[3] = (unsigned char)color;
+    }
+
+    // Two triangles, no index buffer so everything stays one glDrawArrays
+    const int order[6] = { 0, 1, 2, 0, 2, 3 };
+    for (int i : order)
+        m_Vertices.push_back(corner[i]);
+}
+
+void PerfOverlay::AddText(float x, float y, const std::string& text, unsigned int color)
+{
+    for (char character : text)
+    {
+        if (const Glyph* glyph = FindGlyph(character))
+        {
+            for (int row = 0; row < 5; row++)
+            {
+                // Runs of lit pixels become one quad
+                for (int column = 0; column < 3; column++)
+                {
+                    if (!(glyph->rows[row] & (4 >> column)))
+                        continue;
+                    int end = column;
+                    while (end + 1 < 3 && (glyph->rows[row] & (4 >> (end + 1))))
+                        end++;
+                    AddRect(x + column * FONT_SCALE, y + row * FONT_SCALE, (end - column + 1) * FONT_SCALE, FONT_SCALE, color);
+                    column = end;
+                }
+            }
+        }
+        x += CHAR_ADVANCE;
+    }
+}
+
+void PerfOverlay::AddGraph(float x, float y, const std::vector<float>& history, unsigned int color)
+{
+    float scale = GRAPH_HEIGHT / GRAPH_MAX_MS;
+    for (int i = 0; i < HISTORY_LENGTH; i++)
+    {
+        // Oldest on the left
+        float value = std::min(history[(m_HistoryPos + i) % HISTORY_LENGTH], GRAPH_MAX_MS);
+        float height = std::max(value * scale, 1.0f);
+        AddRect(x + i * BAR_WIDTH, y + GRAPH_HEIGHT - height, BAR_WIDTH, height, color);
+    }
+    AddRect(x, y + GRAPH_HEIGHT / 2.0f, HISTORY_LENGTH * BAR_WIDTH, 1.0f, BUDGET_COLOR);
+}
+
+void PerfOverlay::AddFrame(const PerfStats& stats)
+{
+    m_CpuHistory[m_HistoryPos] = (float)stats.cpuMs;
+    m_GpuHistory[m_HistoryPos] = (float)stats.gpuMs;
+    m_HistoryPos = (m_HistoryPos + 1) % HISTORY_LENGTH;
+}
+
+void PerfOverlay::Draw(const PerfStats& stats, int width, int height)
+{
+    PROFILE_SCOPE("PerfOverlay::Draw");
+
+    char line[64];
+    float left = MARGIN + PADDING;
+    float y = MARGIN + PADDING;
+    float graphWidth = HISTORY_LENGTH * BAR_WIDTH;
+
+    m_Vertices.clear();
+    AddRect(MARGIN, MARGIN, graphWidth + 2.0f * PADDING, 2.0f * GRAPH_HEIGHT + 7.0f * LINE_HEIGHT + 4.0f + 2.0f * PADDING, PANEL_COLOR);
+
+    std::snprintf(line, sizeof(line), "CPU %.2f MS", stats.cpuMs);
+    AddText(left, y, line, CPU_COLOR);
+    y += LINE_HEIGHT;
+    AddGraph(left, y, m_CpuHistory, CPU_COLOR);
+    y += GRAPH_HEIGHT + 4.0f;
+
+    std::snprintf(line, sizeof(line), "GPU %.2f MS", stats.gpuMs);
+    AddText(left, y, line, GPU_COLOR);
+    y += LINE_HEIGHT;
+    AddGraph(left, y, m_GpuHistory, GPU_COLOR);
+    y += GRAPH_HEIGHT + 4.0f;
+
+    std::snprintf(line, sizeof(line), "PICK %.2f  CAPTURE %.2f", stats.pickingMs, stats.captureMs);
+    AddText(left, y, line, TEXT_COLOR);
+    y += LINE_HEIGHT;
+    std::snprintf(line, sizeof(line), "DRAWS %u  TRIS %u", stats.render.drawCalls, stats.render.triangles);
+    AddText(left, y, line, TEXT_COLOR);
+    y += LINE_HEIGHT;
+    std::snprintf(line, sizeof(line), "BINDS %u  REDUNDANT %u", stats.render.binds, stats.render.redundantBinds);
+    AddText(left, y, line, TEXT_COLOR);
+    y += LINE_HEIGHT;
+    std::snprintf(line, sizeof(line), "UNIFORMS %u  UPLOAD %.1f KB", stats.render.uniformUploads,
+                  (stats.render.bufferBytes + stats.render.textureBytes) / 1024.0);
+    AddText(left, y, line, TEXT_COLOR);
+    y += LINE_HEIGHT;
+    std::snprintf(line, sizeof(line), "CUBIES %u/%u", stats.cubiesDrawn, stats.cubies);
+    AddText(left, y, line, TEXT_COLOR);
+
+    // Kept out of the statistics it shows
+    RenderStats::SetCounting(false);
+    m_VBO->SetData(m_Vertices.data(), (unsigned int)(m_Vertices.size() * sizeof(Vertex)));
+
+    // On top of the scene, blended
+    GLCall(glDisable(GL_DEPTH_TEST));
+    GLCall(glEnable(GL_BLEND));
+    GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+
+    m_Shader->Bind();
+    m_Shader->SetUniform2f(m_ScreenSize, glm::vec2((float)width, (float)height));
+    m_VAO->Bind();
+    GLCall(glDrawArrays(GL_TRIANGLES, 0, (GLsizei)m_Vertices.size()));
+    RenderStats::CountDraw((unsigned int)m_Vertices.size());
+    m_VAO->Unbind();
+
+    GLCall(glDisable(GL_BLEND));
+    GLCall(glEnable(GL_DEPTH_TEST));
+    RenderStats::SetCounting(true);
+}
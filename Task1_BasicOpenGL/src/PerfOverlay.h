@@ -0,0 +1,61 @@
+#pragma once
+
+#include "RenderStats.h"
+#include "Shader.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+
+#include <string>
+#include <vector>
+
+// What the overlay shows for one frame
+struct PerfStats
+{
+    double cpuMs = 0.0;     // CPU time of the frame, without waiting for events or V-Sync
+    double gpuMs = 0.0;     // GPU time of the main pass
+    double pickingMs = 0.0; // GPU time of the last picking pass
+    double captureMs = 0.0; // GPU time of the last capture readback
+    RenderStats render;     // GL work of the frame, without the overlay itself
+    unsigned int cubiesDrawn = 0;
+    unsigned int cubies = 0;
+};
+
+// CPU and GPU frame time graphs plus counters in the top-left corner. Text
+// and graphs are all colored quads (text from a built-in 3x5 pixel font),
+// drawn in a single call so the overlay barely shows in what it measures.
+class PerfOverlay
+{
+    private:
+        struct Vertex
+        {
+            float position[2];
+            unsigned char color[4];
+        };
+
+        Shader* m_Shader;
+        UniformHandle m_ScreenSize;
+        VertexBuffer* m_VBO;
+        VertexArray* m_VAO;
+        std::vector<Vertex> m_Vertices;
+
+        // Ring of recent frame times for the graphs
+        std::vector<float> m_CpuHistory;
+        std::vector<float> m_GpuHistory;
+        int m_HistoryPos;
+
+        void AddRect(float x, float y, float width, float height, unsigned int color);
+        // Upper case letters, digits and . : / - only
+        void AddText(float x, float y, const std::string& text, unsigned int color);
+        void AddGraph(float x, float y, const std::vector<float>& history, unsigned int color);
+    public:
+        PerfOverlay();
+        ~PerfOverlay();
+
+        PerfOverlay(const PerfOverlay&) = delete;
+        PerfOverlay& operator=(const PerfOverlay&) = delete;
+
+        // Adds the frame to the graphs
+        void AddFrame(const PerfStats& stats);
+        // Over whatever is in the framebuffer, which is width x height pixels
+        void Draw(const PerfStats& stats, int width, int height);
+};
@@ -0,0 +1,133 @@
+#include <PickingBuffer.h>
+#include <Profiler.h>
+
+#include <cstddef>
+
+PickingBuffer::PickingBuffer(int width, int height)
+    : m_FramebufferID(0), m_ColorID(0), m_DepthID(0), m_PixelBufferID(0), m_Fence(nullptr),
+      m_Width(width), m_Height(height), m_PixelX(0), m_PixelY(0)
+{
+    GLCall(glGenFramebuffers(1, &m_FramebufferID));
+    CreateAttachments();
+
+    // Color and depth of the picked pixel land next to each other
+    GLCall(glGenBuffers(1, &m_PixelBufferID));
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_PixelBufferID));
+    GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(PickingResult), nullptr, GL_STREAM_READ));
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+}
+
+PickingBuffer::~PickingBuffer()
+{
+    if (m_Fence)
+    {
+        GLCall(glDeleteSync(m_Fence));
+    }
+
+    DeleteAttachments();
+    GLCall(glDeleteFramebuffers(1, &m_FramebufferID));
+    GLCall(glDeleteBuffers(1, &m_PixelBufferID));
+}
+
+void PickingBuffer::CreateAttachments()
+{
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_FramebufferID));
+
+    GLCall(glGenRenderbuffers(1, &m_ColorID));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_ColorID));
+    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_RG32UI, m_Width, m_Height));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorID));
+
+    GLCall(glGenRenderbuffers(1, &m_DepthID));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_DepthID));
+    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_Width, m_Height));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_DepthID));
+
+    GLCall(GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "Picking framebuffer is incomplete (" << status << ")" << std::endl;
+
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
+
+void PickingBuffer::DeleteAttachments()
+{
+    GLCall(glDeleteRenderbuffers(1, &m_ColorID));
+    GLCall(glDeleteRenderbuffers(1, &m_DepthID));
+}
+
+void PickingBuffer::Resize(int width, int height)
+{
+    if (width <= 0 || height <= 0 || (width == m_Width && height == m_Height))
+        return;
+
+    m_Width = width;
+    m_Height = height;
+    DeleteAttachments();
+    CreateAttachments();
+}
+
+void PickingBuffer::Begin(int pixelX, int pixelY)
+{
+    PROFILE_SCOPE("PickingBuffer::Begin");
+    m_PixelX = pixelX;
+    m_PixelY = pixelY;
+
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_FramebufferID));
+    GLCall(glEnable(GL_SCISSOR_TEST));
+    GLCall(glScissor(pixelX, pixelY, 1, 1));
+
+    // Clear through glClearBuffer so the app's clear color stays untouched
+    const unsigned int background[4] = { 0, 0, 0, 0 };
+    const float farDepth = 1.0f;
+    GLCall(glClearBufferuiv(GL_COLOR, 0, background));
+    GLCall(glClearBufferfv(GL_DEPTH, 0, &farDepth));
+}
+
+void PickingBuffer::End()
+{
+    PROFILE_SCOPE("PickingBuffer::End");
+    // Reads go into the PBO, so these calls return without waiting for the GPU
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_PixelBufferID));
+    GLCall(glReadPixels(m_PixelX, m_PixelY, 1, 1, GL_RG_INTEGER, GL_UNSIGNED_INT, (void*)offsetof(PickingResult, id)));
+    GLCall(glReadPixels(m_PixelX, m_PixelY, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, (void*)offsetof(PickingResult, depth)));
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    // A newer click replaces a pending one
+    if (m_Fence)
+    {
+        GLCall(glDeleteSync(m_Fence));
+    }
+    GLCall(m_Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    GLCall(glFlush());
+
+    GLCall(glDisable(GL_SCISSOR_TEST));
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
+
+bool PickingBuffer::TryGetResult(PickingResult& result, bool wait)
+{
+    PROFILE_SCOPE("PickingBuffer::TryGetResult");
+    if (!m_Fence)
+        return false;
+
+    // Zero timeout polls; a wait gets up to a second
+    GLbitfield flags = wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0;
+    GLuint64 timeout = wait ? 1000000000ull : 0;
+    GLCall(GLenum state = glClientWaitSync(m_Fence, flags, timeout));
+    if (state != GL_ALREADY_SIGNALED && state != GL_CONDITION_SATISFIED)
+        return false;
+
+    GLCall(glDeleteSync(m_Fence));
+    m_Fence = nullptr;
+
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_PixelBufferID));
+    GLCall(const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(PickingResult), GL_MAP_READ_BIT));
+    if (data)
+        result = *(const PickingResult*)data;
+    GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    return data != nullptr;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Debugger.h>
+
+// Values read back from the picking pass (RG32UI color + depth)
+struct PickingResult
+{
+    unsigned int id;   // cubie ID + 1, 0 if nothing was hit
+    unsigned int face; // Face of the cubie that was hit
+    float depth;
+};
+
+// Offscreen target for the picking pass. The clicked pixel is copied into a
+// pixel buffer object and collected a frame later, so the click never waits on the GPU.
+class PickingBuffer
+{
+    private:
+        unsigned int m_FramebufferID;
+        unsigned int m_ColorID;
+        unsigned int m_DepthID;
+        unsigned int m_PixelBufferID;
+        GLsync m_Fence;
+        int m_Width, m_Height;
+        int m_PixelX, m_PixelY;
+    public:
+        PickingBuffer(int width, int height);
+        ~PickingBuffer();
+
+        PickingBuffer(const PickingBuffer&) = delete;
+        PickingBuffer& operator=(const PickingBuffer&) = delete;
+
+        // Should match the default framebuffer size
+        void Resize(int width, int height);
+
+        // Binds the offscreen target and restricts rendering to one pixel (origin bottom-left)
+        void Begin(int pixelX, int pixelY);
+        // Queues the readback and returns to the default framebuffer
+        void End();
+
+        // True once per request, as soon as the GPU has finished the readback.
+        // wait blocks until then instead, for runs that have to be reproducible.
+        bool TryGetResult(PickingResult& result, bool wait = false);
+        inline bool IsPending() const { return m_Fence != nullptr; }
+
+    private:
+        void CreateAttachments();
+        void DeleteAttachments();
+};
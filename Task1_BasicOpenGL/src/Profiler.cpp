@@ -0,0 +1,204 @@
+#include "Profiler.h"
+
+#ifdef ENABLE_PROFILER
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    // Events kept per thread: about 1.5 MB, several seconds of a busy frame loop
+    const uint64_t RING_CAPACITY = 1 << 16;
+
+    // Fields are relaxed atomics so a dump may read a slot while its thread
+    // overwrites it; such slots are detected and skipped (see Collect)
+    struct RingEvent
+    {
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<uint64_t> start{ 0 };
+        std::atomic<uint64_t> end{ 0 };
+    };
+
+    struct CopiedEvent
+    {
+        const char* name;
+        uint64_t start, end;
+        int thread;
+    };
+
+    // Written by its thread only, read by whoever dumps. Kept after the thread
+    // exits, so a dump still shows what it did, until a new thread takes it over.
+    struct ThreadRing
+    {
+        RingEvent events[RING_CAPACITY];
+        std::atomic<uint64_t> head{ 0 }; // events ever written
+        std::string name;
+        int id = 0;
+        bool free = false; // its thread has exited (g_RingsMutex)
+
+        void Push(const char* eventName, uint64_t start, uint64_t end)
+        {
+            uint64_t index = head.load(std::memory_order_relaxed);
+            RingEvent& event = events[index % RING_CAPACITY];
+            event.name.store(eventName, std::memory_order_relaxed);
+            event.start.store(start, std::memory_order_relaxed);
+            event.end.store(end, std::memory_order_relaxed);
+            head.store(index + 1, std::memory_order_release);
+        }
+
+        void Collect(uint64_t since, std::vector<CopiedEvent>& out) const
+        {
+            uint64_t last = head.load(std::memory_order_acquire);
+            uint64_t first = last > RING_CAPACITY ? last - RING_CAPACITY : 0;
+            size_t begin = out.size();
+            for (uint64_t i = first; i < last; i++)
+            {
+                const RingEvent& event = events[i % RING_CAPACITY];
+                out.push_back({ event.name.load(std::memory_order_relaxed), event.start.load(std::memory_order_relaxed),
+                                event.end.load(std::memory_order_relaxed), id });
+            }
+
+            // The thread kept going meanwhile: whatever it may have overwritten
+            // (everything up to head - capacity, plus the slot it is writing) goes
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t now = head.load(std::memory_order_relaxed);
+            uint64_t valid = now + 1 > RING_CAPACITY ? now + 1 - RING_CAPACITY : 0;
+            size_t skip = (size_t)(std::max(valid, first) - first);
+            out.erase(out.begin() + begin, out.begin() + begin + std::min(skip, out.size() - begin));
+
+            out.erase(std::remove_if(out.begin() + begin, out.end(), [since](const CopiedEvent& e) { return e.end < since; }),
+                      out.end());
+        }
+    };
+
+    std::chrono::steady_clock::time_point g_Start = std::chrono::steady_clock::now();
+    std::mutex g_RingsMutex; // only taken when a thread records its first event and on dumps
+    std::vector<std::unique_ptr<ThreadRing>> g_Rings;
+
+    // Hands the ring of a thread back when the thread exits, so short-lived
+    // threads (a WorkerPool per recording) don't add 1.5 MB each
+    struct RingOwner
+    {
+        ThreadRing* ring = nullptr;
+
+        ~RingOwner()
+        {
+            if (!ring)
+                return;
+            std::lock_guard<std::mutex> lock(g_RingsMutex);
+            ring->free = true;
+        }
+    };
+
+    ThreadRing& GetThreadRing()
+    {
+        thread_local RingOwner owner;
+        if (!owner.ring)
+        {
+            std::lock_guard<std::mutex> lock(g_RingsMutex);
+            for (const auto& ring : g_Rings)
+            {
+                if (ring->free)
+                {
+                    // Its old thread is gone and dumps hold the mutex, nobody reads or writes it now
+                    owner.ring = ring.get();
+                    owner.ring->free = false;
+                    owner.ring->head.store(0, std::memory_order_relaxed);
+                    break;
+                }
+            }
+            if (!owner.ring)
+            {
+                g_Rings.push_back(std::make_unique<ThreadRing>());
+                owner.ring = g_Rings.back().get();
+                owner.ring->id = (int)g_Rings.size();
+            }
+            owner.ring->name = "thread " + std::to_string(owner.ring->id);
+        }
+        return *owner.ring;
+    }
+
+    void WriteJsonString(std::FILE* file, const char* text)
+    {
+        std::fputc('"', file);
+        for (; *text; text++)
+        {
+            if (*text == '"' || *text == '\\')
+                std::fputc('\\', file);
+            std::fputc(*text, file);
+        }
+        std::fputc('"', file);
+    }
+}
+
+namespace Profiler
+{
+    uint64_t GetTime()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_Start).count();
+    }
+
+    void Record(const char* name, uint64_t start, uint64_t end)
+    {
+        GetThreadRing().Push(name, start, end);
+    }
+
+    void SetThreadName(const std::string& name)
+    {
+        ThreadRing& ring = GetThreadRing();
+        std::lock_guard<std::mutex> lock(g_RingsMutex);
+        ring.name = name;
+    }
+
+    int WriteTrace(const std::string& path, double seconds)
+    {
+        uint64_t now = GetTime();
+        uint64_t window = (uint64_t)(seconds * 1e9);
+        uint64_t since = now > window ? now - window : 0;
+
+        std::vector<CopiedEvent> events;
+        std::vector<std::pair<int, std::string>> threads;
+        {
+            std::lock_guard<std::mutex> lock(g_RingsMutex);
+            for (const auto& ring : g_Rings)
+            {
+                ring->Collect(since, events);
+                threads.emplace_back(ring->id, ring->name);
+            }
+        }
+
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        if (!file)
+            return -1;
+
+        // Complete ("X") events in microseconds, plus a name per thread
+        std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        bool first = true;
+        for (const auto& thread : threads)
+        {
+            std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", first ? "" : ",\n",
+                         thread.first);
+            WriteJsonString(file, thread.second.c_str());
+            std::fprintf(file, "}}");
+            first = false;
+        }
+        for (const CopiedEvent& event : events)
+        {
+            std::fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+            WriteJsonString(file, event.name ? event.name : "?");
+            std::fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", event.thread,
+                         event.start / 1000.0, (event.end - event.start) / 1000.0);
+            first = false;
+        }
+        std::fprintf(file, "\n]}\n");
+
+        bool ok = std::fclose(file) == 0;
+        return ok ? (int)events.size() : -1;
+    }
+}
+
+#endif
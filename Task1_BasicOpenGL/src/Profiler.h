@@ -0,0 +1,53 @@
+#pragma once
+
+// Scoped CPU profiler. PROFILE_SCOPE("name") times the rest of the enclosing
+// block into a ring buffer of the calling thread; the last few seconds of
+// every thread can be written out as a Chrome trace (chrome://tracing or
+// ui.perfetto.dev). Built only with ENABLE_PROFILER (make PROFILER=1, the
+// default), otherwise the macros expand to nothing.
+
+#ifdef ENABLE_PROFILER
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// name has to outlive the profiler, i.e. be a string literal
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+// Label of the calling thread in the trace
+#define PROFILE_THREAD(name) Profiler::SetThreadName(name)
+
+namespace Profiler
+{
+    // Nanoseconds since the profiler started
+    uint64_t GetTime();
+    void Record(const char* name, uint64_t start, uint64_t end);
+
+    void SetThreadName(const std::string& name);
+    // Every scope that ended in the last seconds, as Chrome trace JSON.
+    // Returns the number of events written, -1 if the file cannot be written.
+    int WriteTrace(const std::string& path, double seconds);
+}
+
+class ProfileScope
+{
+    private:
+        const char* m_Name;
+        uint64_t m_Start;
+    public:
+        ProfileScope(const char* name) : m_Name(name), m_Start(Profiler::GetTime()) {}
+        ~ProfileScope() { Profiler::Record(m_Name, m_Start, Profiler::GetTime()); }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_THREAD(name)
+
+#endif
@@ -0,0 +1,149 @@
+#include <RenderStats.h>
+
+#include <cstdio>
+
+// Bindings as last set through the wrappers, as in a fresh context
+static const unsigned int UNKNOWN_BINDING = 0xFFFFFFFF;
+static const unsigned int MAX_TEXTURE_UNITS = 32;
+static const unsigned int MAX_UNIFORM_BINDINGS = 32;
+
+static unsigned int s_Bound[(int)BindTarget::Count] = {};
+static unsigned int s_BoundTextures[MAX_TEXTURE_UNITS][2] = {}; // Texture2D, Texture2DArray
+static unsigned int s_BoundUniformBlocks[MAX_UNIFORM_BINDINGS] = {};
+static unsigned int s_ActiveUnit = 0;
+
+static RenderStats s_Current;
+static RenderStats s_Uncounted; // sink while counting is off
+static RenderStats* s_Counted = &s_Current;
+static RenderStats s_LastFrame;
+
+static unsigned int& GetBinding(BindTarget target)
+{
+    if (target == BindTarget::Texture2D || target == BindTarget::Texture2DArray)
+    {
+        static unsigned int outOfRange = UNKNOWN_BINDING;
+        if (s_ActiveUnit >= MAX_TEXTURE_UNITS)
+            return outOfRange = UNKNOWN_BINDING;
+        return s_BoundTextures[s_ActiveUnit][target == BindTarget::Texture2D ? 0 : 1];
+    }
+    return s_Bound[(int)target];
+}
+
+RenderStats& RenderStats::operator+=(const RenderStats& other)
+{
+    drawCalls += other.drawCalls;
+    triangles += other.triangles;
+    binds += other.binds;
+    redundantBinds += other.redundantBinds;
+    uniformUploads += other.uniformUploads;
+    bufferBytes += other.bufferBytes;
+    textureBytes += other.textureBytes;
+    return *this;
+}
+
+std::string RenderStats::ToString() const
+{
+    char text[256];
+    std::snprintf(text, sizeof(text), "%u draws, %u triangles, %u binds (%u redundant), %u uniforms, %llu buffer bytes, %llu texture bytes",
+                  drawCalls, triangles, binds, redundantBinds, uniformUploads, bufferBytes, textureBytes);
+    return text;
+}
+
+const RenderStats& RenderStats::GetCurrent()
+{
+    return s_Current;
+}
+
+const RenderStats& RenderStats::GetLastFrame()
+{
+    return s_LastFrame;
+}
+
+void RenderStats::EndFrame()
+{
+    s_LastFrame = s_Current;
+    s_Current = RenderStats();
+}
+
+void RenderStats::SetCounting(bool counting)
+{
+    s_Counted = counting ? &s_Current : &s_Uncounted;
+}
+
+void RenderStats::CountBind(BindTarget target, unsigned int id)
+{
+    unsigned int& bound = GetBinding(target);
+    s_Counted->binds++;
+    if (bound == id)
+        s_Counted->redundantBinds++;
+    bound = id;
+
+    // The element buffer binding belongs to the vertex array
+    if (target == BindTarget::VertexArray)
+        s_Bound[(int)BindTarget::ElementBuffer] = UNKNOWN_BINDING;
+}
+
+void RenderStats::CountBindBase(unsigned int bindingPoint, unsigned int id)
+{
+    s_Counted->binds++;
+    if (bindingPoint < MAX_UNIFORM_BINDINGS)
+    {
+        if (s_BoundUniformBlocks[bindingPoint] == id)
+            s_Counted->redundantBinds++;
+        s_BoundUniformBlocks[bindingPoint] = id;
+    }
+
+    // glBindBufferBase sets the generic binding as well
+    s_Bound[(int)BindTarget::UniformBuffer] = id;
+}
+
+void RenderStats::CountActiveTexture(unsigned int unit)
+{
+    s_ActiveUnit = unit;
+}
+
+void RenderStats::CountDelete(BindTarget target, unsigned int id)
+{
+    if (target == BindTarget::Texture2D || target == BindTarget::Texture2DArray)
+    {
+        int index = target == BindTarget::Texture2D ? 0 : 1;
+        for (auto& unit : s_BoundTextures)
+        {
+            if (unit[index] == id)
+                unit[index] = 0;
+        }
+        return;
+    }
+
+    if (target == BindTarget::UniformBuffer)
+    {
+        for (auto& block : s_BoundUniformBlocks)
+        {
+            if (block == id)
+                block = 0;
+        }
+    }
+    if (s_Bound[(int)target] == id)
+        s_Bound[(int)target] = 0;
+}
+
+void RenderStats::CountDraw(unsigned int vertexCount, unsigned int instanceCount)
+{
+    s_Counted->drawCalls++;
+    s_Counted->triangles += vertexCount / 3 * instanceCount;
+}
+
+void RenderStats::CountUniform()
+{
+    s_Counted->uniformUploads++;
+}
+
+void RenderStats::CountBufferUpload(size_t bytes)
+{
+    s_Counted->bufferBytes += bytes;
+}
+
+void RenderStats::CountTextureUpload(size_t bytes)
+{
+    s_Counted->textureBytes += bytes;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// GL bindings the wrappers keep track of, to tell redundant binds apart
+enum class BindTarget
+{
+    VertexArray,
+    ArrayBuffer,
+    ElementBuffer, // part of the bound vertex array
+    UniformBuffer, // generic binding, see CountBindBase for the indexed ones
+    Program,
+    Texture2D,      // of the active texture unit
+    Texture2DArray, // of the active texture unit
+    Count
+};
+
+// What a frame asked of GL, counted by the wrapper classes (VertexArray,
+// VertexBuffer, IndexBuffer, UniformBuffer, Shader, Texture, TextureArray) and
+// the draw calls of the renderers. A bind of what is already bound counts as
+// redundant. GL calls made around the wrappers are not seen.
+struct RenderStats
+{
+    unsigned int drawCalls = 0;
+    unsigned int triangles = 0;
+    unsigned int binds = 0;
+    unsigned int redundantBinds = 0;
+    unsigned int uniformUploads = 0;      // glUniform* calls
+    unsigned long long bufferBytes = 0;   // vertex, index and uniform data
+    unsigned long long textureBytes = 0;  // texel data
+
+    RenderStats& operator+=(const RenderStats& other);
+    // One line, e.g. for printing on a key press
+    std::string ToString() const;
+
+    // Counters since the last EndFrame. GL thread only, like the wrappers.
+    static const RenderStats& GetCurrent();
+    // Counters of the frame ended by the last EndFrame
+    static const RenderStats& GetLastFrame();
+    static void EndFrame();
+    // Off: calls are not counted (bindings are still tracked), e.g. while
+    // drawing the overlay that shows the counters
+    static void SetCounting(bool counting);
+
+    // Called by the wrappers, right next to the GL call they count
+    static void CountBind(BindTarget target, unsigned int id);
+    static void CountBindBase(unsigned int bindingPoint, unsigned int id);
+    static void CountActiveTexture(unsigned int unit);
+    // Deleted objects are unbound by GL, and their names may come back
+    static void CountDelete(BindTarget target, unsigned int id);
+    // Triangles, counted by vertices (or indices) per instance
+    static void CountDraw(unsigned int vertexCount, unsigned int instanceCount = 1);
+    static void CountUniform();
+    static void CountBufferUpload(size_t bytes);
+    static void CountTextureUpload(size_t bytes);
+};
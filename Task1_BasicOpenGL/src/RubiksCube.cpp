@@ -1,28 +1,53 @@
 #include "RubiksCube.h"
+#include "Profiler.h"
 #include <iostream>
 #include <cmath>
+#include <limits>
 #include <glm/gtc/matrix_transform.hpp>
 
 // Distance between cubies
 static const float SPACING = 2.1f; 
 
+static glm::mat4 GetTurnRotation(const LayerTurn& turn)
+{
+    return glm::rotate(glm::mat4(1.0f), glm::radians(turn.angle), turn.axis);
+}
+
 RubiksCube::RubiksCube(int size)
-    : m_Size(size), m_Mesh(nullptr), m_Shader(nullptr), m_Texture(nullptr)
+    : m_Size(size)
 {
     if (m_Size < 1) m_Size = 1;
 
-    m_Mesh = new CubeMesh();
-    m_Shader = new Shader("res/shaders/basic.shader");
-    m_Texture = new Texture("res/textures/white.png");
-
     Init();
 }
 
-RubiksCube::~RubiksCube()
+unsigned int RubiksCube::GetStickerRect(const Cubie& cubie, Face face) const
 {
-    delete m_Mesh;
-    delete m_Shader;
-    delete m_Texture;
+    if (cubie.stickers[(int)face] == StickerColor::None)
+        return 0xFFFFFFFFu;
+
+    // Stickers never move relative to their cubie, so the solved position
+    // (encoded in the ID) decides which part of the image they show
+    int x = cubie.id / (m_Size * m_Size);
+    int y = (cubie.id / m_Size) % m_Size;
+    int z = cubie.id % m_Size;
+    int last = m_Size - 1;
+
+    // Column and row as seen looking at the face, matching the CubeMesh UVs
+    int column = 0, row = 0;
+    switch (face)
+    {
+    case Face::PosZ: column = x;        row = y;        break;
+    case Face::NegZ: column = last - x; row = y;        break;
+    case Face::PosX: column = last - z; row = y;        break;
+    case Face::NegX: column = z;        row = y;        break;
+    case Face::PosY: column = x;        row = last - z; break;
+    case Face::NegY: column = x;        row = z;        break;
+    }
+
+    unsigned int u = (unsigned int)(65535.0f * column / m_Size + 0.5f);
+    unsigned int v = (unsigned int)(65535.0f * row / m_Size + 0.5f);
+    return u | (v << 16);
 }
 
 void RubiksCube::Init()
@@ -47,6 +72,11 @@ void RubiksCube::Init()
             }
         }
     }
+
+    m_DesyncedCubies.clear();
+    m_SlotToCubie.assign(m_Cubies.size(), -1);
+    for (int i = 0; i < (int)m_Cubies.size(); i++)
+        m_SlotToCubie[GetSlotIndex(m_Cubies[i].currentGridPos)] = i;
 }
 
 void RubiksCube::SetupStickers(Cubie& cubie, int x, int y, int z)
@@ -68,113 +98,86 @@ glm::vec3 RubiksCube::GetInitialPosition(int x, int y, int z) const
     return glm::vec3((x - offset) * SPACING, (y - offset) * SPACING, (z - offset) * SPACING);
 }
 
-void RubiksCube::Draw(const glm::mat4& viewProj, const glm::mat4& globalModel, 
-                      bool isAnimating, glm::vec3 animAxis, float animDeg, 
-                      int layerIndex, int highlightedId)
+bool RubiksCube::IsInTurningLayer(const glm::ivec3& gridPos, const glm::vec3& axis, int layerIndex) const
 {
-    m_Shader->Bind();
-    m_Texture->Bind(0);
-    m_Shader->SetUniform1i("u_Texture", 0);
-    m_Mesh->Bind();
+    int x = gridPos.x;
+    int y = gridPos.y;
+    int z = gridPos.z;
 
-    for (const auto& cubie : m_Cubies)
+    if (layerIndex == -1)
     {
-        int x = cubie.currentGridPos.x;
-        int y = cubie.currentGridPos.y;
-        int z = cubie.currentGridPos.z;
+        if      (axis.x > 0.5f && x == m_Size - 1) return true; 
+        else if (axis.x < -0.5f && x == 0)           return true; 
+        else if (axis.y > 0.5f && y == m_Size - 1) return true; 
+        else if (axis.y < -0.5f && y == 0)           return true; 
+        else if (axis.z > 0.5f && z == m_Size - 1) return true; 
+        else if (axis.z < -0.5f && z == 0)           return true; 
+    }
+    else
+    {
+        if      (std::abs(axis.x) > 0.9f && x == layerIndex) return true;
+        else if (std::abs(axis.y) > 0.9f && y == layerIndex) return true;
+        else if (std::abs(axis.z) > 0.9f && z == layerIndex) return true;
+    }
+    return false;
+}
 
-        glm::vec3 currentPos = GetInitialPosition(x, y, z);
-        glm::mat4 animRot = glm::mat4(1.0f);
+int RubiksCube::FindTurn(const glm::ivec3& gridPos, const std::vector<LayerTurn>& turns) const
+{
+    for (size_t i = 0; i < turns.size(); i++)
+    {
+        if (IsInTurningLayer(gridPos, turns[i].axis, turns[i].layer))
+            return (int)i;
+    }
+    return -1;
+}
 
-        if (isAnimating)
-        {
-            bool shouldRotate = false;
+void RubiksCube::GetDrawData(std::vector<CubieDrawData>& draws, const std::vector<LayerTurn>& turns,
+                             int highlightedId) const
+{
+    PROFILE_SCOPE("RubiksCube::GetDrawData");
+    draws.resize(m_Cubies.size());
 
-            if (layerIndex == -1)
-            {
-                if      (animAxis.x > 0.5f && x == m_Size - 1) shouldRotate = true; 
-                else if (animAxis.x < -0.5f && x == 0)           shouldRotate = true; 
-                else if (animAxis.y > 0.5f && y == m_Size - 1) shouldRotate = true; 
-                else if (animAxis.y < -0.5f && y == 0)           shouldRotate = true; 
-                else if (animAxis.z > 0.5f && z == m_Size - 1) shouldRotate = true; 
-                else if (animAxis.z < -0.5f && z == 0)           shouldRotate = true; 
-            }
-            else
-            {
-                if      (std::abs(animAxis.x) > 0.9f && x == layerIndex) shouldRotate = true;
-                else if (std::abs(animAxis.y) > 0.9f && y == layerIndex) shouldRotate = true;
-                else if (std::abs(animAxis.z) > 0.9f && z == layerIndex) shouldRotate = true;
-            }
+    // One rotation per turning layer, applied to every cubie in it
+    std::vector<glm::mat4> rotations(turns.size());
+    for (size_t i = 0; i < turns.size(); i++)
+        rotations[i] = GetTurnRotation(turns[i]);
 
-            if (shouldRotate)
-            {
-                animRot = glm::rotate(glm::mat4(1.0f), glm::radians(animDeg), animAxis);
-            }
-        }
+    // A turning layer or a piece moved by hand can open up the inside
+    bool closed = turns.empty() && m_DesyncedCubies.empty();
 
-        // --- Corrected: No Scaling, just draw the model ---
-        // If you want to highlight, you could change the u_Color slightly, 
-        // but the requirement is Translation/Rotation, so we leave scale at 1.0f.
-        glm::mat4 model = globalModel * cubie.BuildModel(currentPos, animRot, 1.0f);
-        glm::mat4 mvp = viewProj * model;
+    for (size_t i = 0; i < m_Cubies.size(); i++)
+    {
+        const Cubie& cubie = m_Cubies[i];
+        CubieDrawData& draw = draws[i];
+        draw.highlighted = cubie.id == highlightedId;
+        draw.hidden = closed && !cubie.HasStickers();
 
-        m_Shader->SetUniformMat4f("u_MVP", mvp);
+        glm::vec3 currentPos = GetInitialPosition(cubie.currentGridPos.x, cubie.currentGridPos.y, cubie.currentGridPos.z);
+        draw.id = cubie.id;
+        draw.model = cubie.BuildModel(currentPos, glm::mat4(1.0f), 1.0f);
 
-        Face groupToFace[6] = {
-            Face::PosZ, Face::NegZ,
-            Face::PosX, Face::NegX,
-            Face::PosY, Face::NegY
-        };
+        int turn = FindTurn(cubie.currentGridPos, turns);
+        if (turn != -1)
+            draw.model = rotations[turn] * draw.model;
 
-        for (int group = 0; group < 6; ++group)
+        for (int f = 0; f < 6; f++)
         {
-            Face f = groupToFace[group];
-            StickerColor sc = cubie.stickers[(int)f];
-
-            glm::vec4 colorVec;
+            StickerColor sc = cubie.stickers[f];
             if (sc == StickerColor::None)
-                colorVec = glm::vec4(0.05f, 0.05f, 0.05f, 1.0f); 
+                draw.faceColors[f] = glm::vec4(0.05f, 0.05f, 0.05f, 1.0f); 
             else
-                colorVec = StickerToVec4(sc);
+                draw.faceColors[f] = StickerToVec4(sc);
 
-            m_Shader->SetUniform4f("u_Color", colorVec);
+            // Hover highlight: lift every face towards white
+            if (draw.highlighted)
+                draw.faceColors[f] = glm::vec4(glm::vec3(draw.faceColors[f]) * 0.6f + 0.4f, 1.0f);
 
-            const void* offset = (const void*)(group * 6 * sizeof(unsigned int));
-            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, offset);
+            draw.stickerRects[f] = GetStickerRect(cubie, (Face)f);
         }
     }
 }
 
-void RubiksCube::DrawPicking(const glm::mat4& viewProj, const glm::mat4& globalModel)
-{
-    m_Shader->Bind();
-    m_Shader->SetUniform1i("u_PickingMode", 1); 
-    m_Mesh->Bind();
-
-    for (const auto& cubie : m_Cubies)
-    {
-        int x = cubie.currentGridPos.x;
-        int y = cubie.currentGridPos.y;
-        int z = cubie.currentGridPos.z;
-
-        glm::vec3 currentPos = GetInitialPosition(x, y, z);
-        
-        // For picking, we assume no active animation keyframe
-        glm::mat4 model = globalModel * cubie.BuildModel(currentPos, glm::mat4(1.0f), 1.0f);
-        glm::mat4 mvp = viewProj * model;
-
-        m_Shader->SetUniformMat4f("u_MVP", mvp);
-
-        // Encode ID
-        float r = (float)cubie.id / 255.0f;
-        glm::vec4 idColor = glm::vec4(r, 0.0f, 0.0f, 1.0f);
-        m_Shader->SetUniform4f("u_Color", idColor);
-
-        glDrawElements(GL_TRIANGLES, m_Mesh->GetIndexCount(), GL_UNSIGNED_INT, nullptr);
-    }
-    m_Shader->SetUniform1i("u_PickingMode", 0);
-}
-
 void RubiksCube::UpdateCubieDesync(int id, const glm::mat4& deltaTransform)
 {
     // Apply a transformation to a specific cubie (for the bonus requirement)
@@ -184,6 +187,9 @@ void RubiksCube::UpdateCubieDesync(int id, const glm::mat4& deltaTransform)
         {
             // Apply the transformation on top of its existing local rotation
             cubie.localRotation = deltaTransform * cubie.localRotation;
+            if (!cubie.desynced)
+                m_DesyncedCubies.push_back(cubie.id);
+            cubie.desynced = true;
             break;
         }
     }
@@ -191,31 +197,17 @@ void RubiksCube::UpdateCubieDesync(int id, const glm::mat4& deltaTransform)
 
 void RubiksCube::FinishTurn(glm::vec3 axis, float deg, int layerIndex)
 {
+    PROFILE_SCOPE("RubiksCube::FinishTurn");
     glm::mat4 rot = glm::rotate(glm::mat4(1.0f), glm::radians(deg), axis);
     float center = (m_Size - 1) / 2.0f;
+    std::vector<int> rotated;
 
     for (auto& cubie : m_Cubies)
     {
-        bool shouldRotate = false;
         int x = cubie.currentGridPos.x;
         int y = cubie.currentGridPos.y;
         int z = cubie.currentGridPos.z;
-
-        if (layerIndex == -1)
-        {
-            if      (axis.x > 0.5f && x == m_Size - 1) shouldRotate = true;
-            else if (axis.x < -0.5f && x == 0)           shouldRotate = true;
-            else if (axis.y > 0.5f && y == m_Size - 1) shouldRotate = true;
-            else if (axis.y < -0.5f && y == 0)           shouldRotate = true;
-            else if (axis.z > 0.5f && z == m_Size - 1) shouldRotate = true;
-            else if (axis.z < -0.5f && z == 0)           shouldRotate = true;
-        }
-        else
-        {
-            if      (std::abs(axis.x) > 0.9f && x == layerIndex) shouldRotate = true;
-            else if (std::abs(axis.y) > 0.9f && y == layerIndex) shouldRotate = true;
-            else if (std::abs(axis.z) > 0.9f && z == layerIndex) shouldRotate = true;
-        }
+        bool shouldRotate = IsInTurningLayer(cubie.currentGridPos, axis, layerIndex);
 
         if (shouldRotate)
         {
@@ -227,10 +219,42 @@ void RubiksCube::FinishTurn(glm::vec3 axis, float deg, int layerIndex)
             cubie.currentGridPos.z = (int)std::round(pNew.z + center);
 
             cubie.localRotation = rot * cubie.localRotation;
+            rotated.push_back(&cubie - &m_Cubies[0]);
         }
     }
+
+    // Only the turned layer changes slots, the rest of the grid stays valid
+    for (int index : rotated)
+        m_SlotToCubie[GetSlotIndex(m_Cubies[index].currentGridPos)] = index;
 }
 
+void RubiksCube::GetState(CubeState& state) const
+{
+    state.Reset(m_Size);
+    for (const auto& cubie : m_Cubies)
+    {
+        state.slots[cubie.id] = (uint32_t)GetSlotIndex(cubie.currentGridPos);
+        state.orientations[cubie.id] = (uint8_t)FindCubeRotation(glm::mat3(cubie.localRotation));
+    }
+}
+
+bool RubiksCube::SetState(const CubeState& state)
+{
+    PROFILE_SCOPE("RubiksCube::SetState");
+    if (state.size != m_Size)
+        return false;
+
+    // Init puts every cubie at index == ID
+    Init();
+    for (auto& cubie : m_Cubies)
+    {
+        int slot = state.slots[cubie.id];
+        cubie.currentGridPos = glm::ivec3(slot / (m_Size * m_Size), (slot / m_Size) % m_Size, slot % m_Size);
+        cubie.localRotation = glm::mat4(GetCubeRotation(state.orientations[cubie.id]));
+        m_SlotToCubie[slot] = cubie.id;
+    }
+    return true;
+}
 
 void RubiksCube::SetCubiePosition(int id, const glm::vec3& newPos)
 {
@@ -241,7 +265,197 @@ void RubiksCube::SetCubiePosition(int id, const glm::vec3& newPos)
             glm::vec3 originalPos = GetInitialPosition(cubie.currentGridPos.x, cubie.currentGridPos.y, cubie.currentGridPos.z);
             
             cubie.translationOffset = newPos - originalPos;
+            if (!cubie.desynced)
+                m_DesyncedCubies.push_back(cubie.id);
+            cubie.desynced = true;
             break;
         }
     }
+}
+
+bool RubiksCube::IntersectCubie(const Cubie& cubie, const glm::mat4& wallAnimRotation, const glm::vec3& origin,
+                                const glm::vec3& direction, RayHit& hit) const
+{
+    // Same transform as Cubie::BuildModel, but rigid, so the inverse is a transpose
+    glm::mat3 wall = glm::mat3(wallAnimRotation);
+    glm::mat3 rotation = wall * glm::mat3(cubie.localRotation);
+    glm::vec3 center = wall * (GetInitialPosition(cubie.currentGridPos.x, cubie.currentGridPos.y, cubie.currentGridPos.z) + cubie.translationOffset);
+
+    // Slab test against the [-1, 1] mesh box in the cubie's own space.
+    // The ray parameter is the same in every space.
+    glm::mat3 inverseRotation = glm::transpose(rotation);
+    glm::vec3 o = inverseRotation * (origin - center);
+    glm::vec3 d = inverseRotation * direction;
+
+    float tNear = -std::numeric_limits<float>::max();
+    float tFar = std::numeric_limits<float>::max();
+    int nearAxis = 0;
+    float nearSign = 1.0f;
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        if (std::abs(d[axis]) < 1e-8f)
+        {
+            if (o[axis] < -1.0f || o[axis] > 1.0f)
+                return false;
+            continue;
+        }
+
+        float t0 = (-1.0f - o[axis]) / d[axis];
+        float t1 = ( 1.0f - o[axis]) / d[axis];
+        // Entering through the -1 plane means we hit the negative face
+        float sign = -1.0f;
+        if (t0 > t1) { std::swap(t0, t1); sign = 1.0f; }
+
+        if (t0 > tNear) { tNear = t0; nearAxis = axis; nearSign = sign; }
+        tFar = std::min(tFar, t1);
+        if (tNear > tFar)
+            return false;
+    }
+
+    if (tFar < 0.0f || tNear < 0.0f || tNear >= hit.distance)
+        return false;
+
+    static const Face faces[3][2] = {
+        { Face::NegX, Face::PosX },
+        { Face::NegY, Face::PosY },
+        { Face::NegZ, Face::PosZ }
+    };
+
+    hit.cubieId = cubie.id;
+    hit.face = faces[nearAxis][nearSign > 0.0f ? 1 : 0];
+    hit.distance = tNear;
+    return true;
+}
+
+bool RubiksCube::RayCast(const glm::vec3& origin, const glm::vec3& direction, const glm::mat4& globalModel,
+                         RayHit& hit, const std::vector<LayerTurn>& turns) const
+{
+    PROFILE_SCOPE("RubiksCube::RayCast");
+    // Work in cube space, where the slots form an axis aligned grid
+    glm::mat4 inverseGlobal = glm::inverse(globalModel);
+    glm::vec3 o = glm::vec3(inverseGlobal * glm::vec4(origin, 1.0f));
+    glm::vec3 d = glm::vec3(inverseGlobal * glm::vec4(direction, 0.0f));
+
+    RayHit best;
+    best.distance = std::numeric_limits<float>::max();
+
+    // 1. Cubies that are not in a grid cell: the turning layers (scanned by slot,
+    //    so O(N^2) each) and the few cubies that were moved by hand.
+    std::vector<glm::mat4> rotations(turns.size());
+    for (size_t i = 0; i < turns.size(); i++)
+    {
+        const LayerTurn& turn = turns[i];
+        rotations[i] = GetTurnRotation(turn);
+
+        int axis = (std::abs(turn.axis.x) > 0.5f) ? 0 : ((std::abs(turn.axis.y) > 0.5f) ? 1 : 2);
+        int layer = turn.layer;
+        if (layer == -1)
+            layer = (turn.axis[axis] > 0.0f) ? m_Size - 1 : 0;
+
+        for (int a = 0; a < m_Size; a++)
+        {
+            for (int b = 0; b < m_Size; b++)
+            {
+                glm::ivec3 slot;
+                slot[axis] = layer;
+                slot[(axis + 1) % 3] = a;
+                slot[(axis + 2) % 3] = b;
+
+                int index = m_SlotToCubie[GetSlotIndex(slot)];
+                if (index == -1 || m_Cubies[index].desynced)
+                    continue;
+
+                IntersectCubie(m_Cubies[index], rotations[i], o, d, best);
+            }
+        }
+    }
+
+    for (int id : m_DesyncedCubies)
+    {
+        const Cubie& cubie = m_Cubies[id];
+        int turn = FindTurn(cubie.currentGridPos, turns);
+        IntersectCubie(cubie, turn != -1 ? rotations[turn] : glm::mat4(1.0f), o, d, best);
+    }
+
+    // 2. Walk the grid front to back (3D DDA). An aligned cubie stays inside its
+    //    cell, so the first hit is the nearest one and the walk can stop there.
+    float half = SPACING * 0.5f;
+    float extent = (m_Size - 1) / 2.0f * SPACING + half;
+
+    float tEnter = 0.0f, tExit = std::numeric_limits<float>::max();
+    for (int axis = 0; axis < 3; axis++)
+    {
+        if (std::abs(d[axis]) < 1e-8f)
+        {
+            if (o[axis] < -extent || o[axis] > extent) tExit = -1.0f;
+            continue;
+        }
+        float t0 = (-extent - o[axis]) / d[axis];
+        float t1 = ( extent - o[axis]) / d[axis];
+        if (t0 > t1) std::swap(t0, t1);
+        tEnter = std::max(tEnter, t0);
+        tExit = std::min(tExit, t1);
+    }
+
+    if (tEnter <= tExit && tEnter < best.distance)
+    {
+        glm::vec3 start = o + d * tEnter;
+        glm::ivec3 cell, step;
+        glm::vec3 tMax, tDelta;
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float local = (start[axis] + extent) / SPACING;
+            cell[axis] = std::min(m_Size - 1, std::max(0, (int)std::floor(local)));
+
+            if (d[axis] > 0.0f)
+            {
+                step[axis] = 1;
+                tDelta[axis] = SPACING / d[axis];
+                tMax[axis] = tEnter + ((cell[axis] + 1) * SPACING - extent - start[axis]) / d[axis];
+            }
+            else if (d[axis] < 0.0f)
+            {
+                step[axis] = -1;
+                tDelta[axis] = -SPACING / d[axis];
+                tMax[axis] = tEnter + (cell[axis] * SPACING - extent - start[axis]) / d[axis];
+            }
+            else
+            {
+                step[axis] = 0;
+                tDelta[axis] = std::numeric_limits<float>::max();
+                tMax[axis] = std::numeric_limits<float>::max();
+            }
+        }
+
+        while (cell.x >= 0 && cell.y >= 0 && cell.z >= 0 && cell.x < m_Size && cell.y < m_Size && cell.z < m_Size)
+        {
+            float cellEnter = std::min(tMax.x, std::min(tMax.y, tMax.z));
+
+            int index = m_SlotToCubie[GetSlotIndex(cell)];
+            if (index != -1)
+            {
+                const Cubie& cubie = m_Cubies[index];
+                bool handled = cubie.desynced || FindTurn(cubie.currentGridPos, turns) != -1;
+                if (!handled && IntersectCubie(cubie, glm::mat4(1.0f), o, d, best))
+                    break;
+            }
+
+            // Nothing in the grid beyond this point can beat an earlier hit
+            if (cellEnter > best.distance)
+                break;
+
+            int axis = (tMax.x < tMax.y) ? ((tMax.x < tMax.z) ? 0 : 2) : ((tMax.y < tMax.z) ? 1 : 2);
+            cell[axis] += step[axis];
+            tMax[axis] += tDelta[axis];
+        }
+    }
+
+    if (best.cubieId == -1)
+        return false;
+
+    best.point = origin + direction * best.distance;
+    hit = best;
+    return true;
 }
\ No newline at end of file
@@ -3,41 +3,88 @@
 #include "Cubie.h"
 #include <vector>
 #include <glm/glm.hpp>
-#include "Shader.h"
-#include "Texture.h"
-#include "CubeMesh.h"
+#include "Move.h"
+#include "CubeState.h"
 
+// A layer part way through a turn. Turns drawn together must not share cubies:
+// same axis, different layers.
+struct LayerTurn
+{
+    glm::vec3 axis = glm::vec3(0.0f);
+    float angle = 0.0f; // degrees so far, signed
+    int layer = -1;     // -1 = outer layer on the axis' side
+};
+
+// Everything needed to draw one cubie, shared by the GL and software renderers
+struct CubieDrawData
+{
+    int id = 0;
+    glm::mat4 model = glm::mat4(1.0f); // with its layer's turn, before the global rotation
+    glm::vec4 faceColors[6];           // by Face, already highlighted
+    unsigned int stickerRects[6];      // part of the face picture each sticker shows, see GetStickerRect
+    bool highlighted = false;
+    bool hidden = false;               // inner piece, out of sight while nothing is turning or moved by hand
+};
+
+// Result of RubiksCube::RayCast
+struct RayHit
+{
+    int cubieId = -1;
+    Face face = Face::PosY;   // face of the cubie (index into its stickers)
+    float distance = 0.0f;    // along the ray, in units of the ray direction
+    glm::vec3 point = glm::vec3(0.0f); // world space
+};
+
+// Cube logic only, drawn by CubeRenderer (GL) or SoftwareRenderer from its
+// GetDrawData, so it needs no context.
 class RubiksCube
 {
 public:
     RubiksCube(int size = 3);
-    ~RubiksCube();
 
     void Init();
-    
-    // Standard Draw
-    void Draw(const glm::mat4& viewProj, const glm::mat4& globalModel, 
-              bool isAnimating = false, glm::vec3 animAxis = glm::vec3(0), float animDeg = 0.0f, 
-              int layerIndex = -1, int highlightedId = -1);
-              
-    // Picking Draw (Colors = IDs)
-    void DrawPicking(const glm::mat4& viewProj, const glm::mat4& globalModel);
+
+    // Per-cubie transforms and colors for a frame, turns are the layers currently turning
+    void GetDrawData(std::vector<CubieDrawData>& draws, const std::vector<LayerTurn>& turns = {},
+                     int highlightedId = -1) const;
 
     void FinishTurn(glm::vec3 axis, float deg, int layerIndex = -1);
+    // Applies a turn instantly, without animation
+    void ApplyMove(const Move& move) { FinishTurn(move.GetAxisVector(), move.GetDegrees(), move.layer); }
     
+    // Slots and orientations of all cubies. Hand-moved cubies count as being in
+    // their grid slot with the nearest right-angle rotation.
+    void GetState(CubeState& state) const;
+    // Replaces the whole cube, false (and nothing changes) if the size differs
+    bool SetState(const CubeState& state);
+
+    // CPU picking against the cubies' boxes, including the layers that are mid-turn.
+    // Takes the same turns as GetDrawData.
+    bool RayCast(const glm::vec3& origin, const glm::vec3& direction, const glm::mat4& globalModel,
+                 RayHit& hit, const std::vector<LayerTurn>& turns = {}) const;
+
     // NEW: Function to manipulate a single picked cube
     void UpdateCubieDesync(int id, const glm::mat4& deltaTransform);
     void SetCubiePosition(int id, const glm::vec3& newPos);
     int GetSize() const { return m_Size; }
 
 private:
+    // Corner of the sticker in its face picture (unorm16 u, v), 0xFFFFFFFF for faces without one
+    unsigned int GetStickerRect(const Cubie& cubie, Face face) const;
+
     void SetupStickers(Cubie& cubie, int x, int y, int z);
     glm::vec3 GetInitialPosition(int x, int y, int z) const;
+    bool IsInTurningLayer(const glm::ivec3& gridPos, const glm::vec3& axis, int layerIndex) const;
+    // Index into turns of the one moving this slot, -1 if none
+    int FindTurn(const glm::ivec3& gridPos, const std::vector<LayerTurn>& turns) const;
+
+    // Slot index (x, y, z) -> index into m_Cubies, used to walk the ray through the grid
+    int GetSlotIndex(const glm::ivec3& gridPos) const { return (gridPos.x * m_Size + gridPos.y) * m_Size + gridPos.z; }
+    bool IntersectCubie(const Cubie& cubie, const glm::mat4& wallAnimRotation, const glm::vec3& origin,
+                        const glm::vec3& direction, RayHit& hit) const;
 
     int m_Size;
     std::vector<Cubie> m_Cubies;
-    
-    CubeMesh* m_Mesh;
-    Shader* m_Shader;
-    Texture* m_Texture;
+    std::vector<int> m_SlotToCubie;
+    std::vector<int> m_DesyncedCubies; // left the grid, tested one by one when picking
 };
\ No newline at end of file
@@ -1,14 +1,89 @@
 #include <Shader.h>
+#include <GLExtensions.h>
+#include <Profiler.h>
+#include <RenderStats.h>
 
-Shader::Shader(const std::string& filepath)
-    : m_Filepath(filepath), m_RendererID(0)
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+// Program binaries are stored here, relative to the working directory
+static const char* PROGRAM_CACHE_DIR = "shadercache";
+
+// Header written in front of every cached program binary
+struct ProgramCacheHeader
+{
+    char magic[4];
+    uint32_t binaryFormat;
+    uint32_t length;
+};
+
+static const char PROGRAM_CACHE_MAGIC[4] = { 'S', 'P', 'B', '1' };
+
+// 64-bit FNV-1a
+static uint64_t HashString(const std::string& text, uint64_t hash = 14695981039346656037ULL)
+{
+    for (unsigned char c : text)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// glProgramBinary fails with GL_INVALID_ENUM on formats the driver does not list
+static bool IsProgramBinaryFormatSupported(GLenum format)
+{
+    int count = 0;
+    GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count));
+    if (count <= 0)
+        return false;
+
+    std::vector<int> formats(count);
+    GLCall(glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data()));
+    for (int supported : formats)
+        if ((GLenum)supported == format)
+            return true;
+    return false;
+}
+
+Shader::Shader(const std::string& filepath, const std::vector<std::string>& defines)
+    : m_Filepath(filepath), m_Defines(defines), m_RendererID(0), m_LoadTimeMs(0.0), m_LoadedFromCache(false)
 {
+    PROFILE_SCOPE("Shader::Shader");
+    auto start = std::chrono::steady_clock::now();
+
     ShaderProgramSource source = ParseShader(filepath);
-    m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+    source.VertexSource = InjectDefines(source.VertexSource);
+    source.FragmentSource = InjectDefines(source.FragmentSource);
+
+    std::string cachePath = GetProgramCachePath(source);
+    if (!cachePath.empty())
+        m_RendererID = LoadCachedProgram(cachePath);
+
+    m_LoadedFromCache = m_RendererID != 0;
+    if (!m_LoadedFromCache)
+    {
+        m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+        if (m_RendererID != 0 && !cachePath.empty())
+            SaveCachedProgram(m_RendererID, cachePath);
+    }
+
+    CacheUniformLocations();
+
+    m_LoadTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Shader '" << filepath << "'";
+    for (const auto& define : m_Defines)
+        std::cout << " " << define;
+    std::cout << " " << (m_LoadedFromCache ? "loaded from cache" : "compiled") << " in " << m_LoadTimeMs << " ms" << std::endl;
 }
 
 Shader::~Shader()
 {
+    RenderStats::CountDelete(BindTarget::Program, m_RendererID);
     GLCall(glDeleteProgram(m_RendererID));
 }
 
@@ -46,6 +121,29 @@ ShaderProgramSource Shader::ParseShader(const std::string& filepath)
     return { ss[0].str(), ss[1].str() };
 }
 
+std::string Shader::InjectDefines(const std::string& source) const
+{
+    if (m_Defines.empty())
+        return source;
+
+    std::string defines;
+    for (const auto& define : m_Defines)
+        defines += "#define " + define + "\n";
+
+    // #version has to stay the first statement, so the defines go right after it
+    size_t insertAt = 0;
+    size_t version = source.find("#version");
+    if (version != std::string::npos)
+    {
+        size_t lineEnd = source.find('\n', version);
+        insertAt = (lineEnd == std::string::npos) ? source.size() : lineEnd + 1;
+    }
+
+    std::string result = source;
+    result.insert(insertAt, defines);
+    return result;
+}
+
 unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 {
     GLCall(unsigned int id = glCreateShader(type));
@@ -78,58 +176,242 @@ unsigned int Shader::CreateShader(const std::string& vertexShader, const std::st
 
     GLCall(glAttachShader(program, vs));
     GLCall(glAttachShader(program, fs));
+
+    // Must be set before linking for glGetProgramBinary to return anything
+    if (GLExt_ProgramBinary)
+    {
+        GLCall(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+
     GLCall(glLinkProgram(program));
     GLCall(glValidateProgram(program));
 
     GLCall(glDeleteShader(vs));
     GLCall(glDeleteShader(fs));
 
+    int result;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &result));
+    if (result == GL_FALSE)
+    {
+        int length;
+        GLCall(glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length));
+        std::string message(length, '\0');
+        GLCall(glGetProgramInfoLog(program, length, &length, &message[0]));
+        std::cout << "Failed to link shader program " << m_Filepath << std::endl;
+        std::cout << message << std::endl;
+        GLCall(glDeleteProgram(program));
+        return 0;
+    }
+
     return program;
 }
 
-void Shader::Bind() const
+std::string Shader::GetProgramCachePath(const ShaderProgramSource& source) const
 {
-    GLCall(glUseProgram(m_RendererID));
+    if (!GLExt_ProgramBinary)
+        return "";
+
+    // Binaries are only valid for the exact driver that produced them
+    uint64_t hash = HashString(source.VertexSource);
+    hash = HashString(source.FragmentSource, hash);
+    hash = HashString((const char*)glGetString(GL_VENDOR), hash);
+    hash = HashString((const char*)glGetString(GL_RENDERER), hash);
+    hash = HashString((const char*)glGetString(GL_VERSION), hash);
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)hash);
+    return std::string(PROGRAM_CACHE_DIR) + "/" + name;
 }
 
-void Shader::Unbind() const
+unsigned int Shader::LoadCachedProgram(const std::string& cachePath)
 {
-    GLCall(glUseProgram(0));
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file)
+        return 0;
+
+    ProgramCacheHeader header;
+    if (!file.read((char*)&header, sizeof(header)) || memcmp(header.magic, PROGRAM_CACHE_MAGIC, sizeof(header.magic)) != 0)
+        return 0;
+
+    // A truncated or corrupt file is a miss, before the length gets allocated
+    std::error_code ec;
+    uintmax_t fileSize = std::filesystem::file_size(cachePath, ec);
+    if (ec || header.length == 0 || fileSize != sizeof(header) + (uintmax_t)header.length)
+        return 0;
+    if (!IsProgramBinaryFormatSupported(header.binaryFormat))
+        return 0;
+
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), header.length))
+        return 0;
+
+    GLCall(unsigned int program = glCreateProgram());
+    GLCall(glProgramBinary(program, header.binaryFormat, binary.data(), header.length));
+
+    // Driver updates invalidate binaries, in that case we compile from source again
+    int result;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &result));
+    if (result == GL_FALSE)
+    {
+        GLCall(glDeleteProgram(program));
+        return 0;
+    }
+
+    return program;
 }
 
-void Shader::SetUniform1i(const std::string& name, int value)
+void Shader::SaveCachedProgram(unsigned int program, const std::string& cachePath)
 {
-    GLCall(glUniform1i(GetUniformLocation(name), value));
+    int length = 0;
+    GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0)
+        return;
+
+    ProgramCacheHeader header;
+    memcpy(header.magic, PROGRAM_CACHE_MAGIC, sizeof(header.magic));
+    std::vector<char> binary(length);
+
+    GLenum format = 0;
+    GLCall(glGetProgramBinary(program, length, &length, &format, binary.data()));
+    header.binaryFormat = format;
+    header.length = (uint32_t)length;
+
+    std::error_code error;
+    std::filesystem::create_directories(PROGRAM_CACHE_DIR, error);
+
+    std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return;
+
+    file.write((const char*)&header, sizeof(header));
+    file.write(binary.data(), length);
 }
 
-void Shader::SetUniform1f(const std::string& name, float value)
+void Shader::Bind() const
 {
-    GLCall(glUniform1f(GetUniformLocation(name), value));
+    RenderStats::CountBind(BindTarget::Program, m_RendererID);
+    GLCall(glUseProgram(m_RendererID));
 }
 
-void Shader::SetUniform4f(const std::string& name, glm::vec4& value)
+void Shader::Unbind() const
 {
-    GLCall(glUniform4f(GetUniformLocation(name), value.x, value.y, value.z, value.w));
+    RenderStats::CountBind(BindTarget::Program, 0);
+    GLCall(glUseProgram(0));
 }
 
-void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
+void Shader::CacheUniformLocations()
 {
-    GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
+    int count = 0;
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &count));
+
+    int maxLength = 0;
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+    std::string name(maxLength, '\0');
+
+    for (int i = 0; i < count; i++)
+    {
+        int length = 0, size = 0;
+        unsigned int type = 0;
+        GLCall(glGetActiveUniform(m_RendererID, i, maxLength, &length, &size, &type, &name[0]));
+
+        std::string uniformName = name.substr(0, length);
+        GLCall(int location = glGetUniformLocation(m_RendererID, uniformName.c_str()));
+
+        // Uniforms inside a block have no location, they are set through the UBO
+        if (location == -1)
+            continue;
+
+        m_UniformLocationCache[uniformName] = location;
+
+        // Arrays are reported as "name[0]", allow looking them up by "name" too
+        size_t bracket = uniformName.find('[');
+        if (bracket != std::string::npos)
+            m_UniformLocationCache[uniformName.substr(0, bracket)] = location;
+    }
 }
 
-int Shader::GetUniformLocation(const std::string& name)
+UniformHandle Shader::GetUniformHandle(const std::string& name) const
 {
-    if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
+    auto it = m_UniformLocationCache.find(name);
+    if (it == m_UniformLocationCache.end())
     {
-        return m_UniformLocationCache[name];
+        std::cout << "Warning: uniform '" << name << "' doesn't exist!" << std::endl;
+        return UniformHandle();
     }
 
-    GLCall(int location = glGetUniformLocation(m_RendererID, name.c_str()));
-    if (location == -1)
+    return UniformHandle{ it->second };
+}
+
+void Shader::BindUniformBlock(const std::string& blockName, unsigned int bindingPoint)
+{
+    GLCall(unsigned int index = glGetUniformBlockIndex(m_RendererID, blockName.c_str()));
+    if (index == GL_INVALID_INDEX)
     {
-        std::cout << "Warning: uniform '" << name << "' doesn't exist!" << std::endl;
+        std::cout << "Warning: uniform block '" << blockName << "' doesn't exist!" << std::endl;
+        return;
     }
-    
-    m_UniformLocationCache[name] = location;
-    return location;
+
+    GLCall(glUniformBlockBinding(m_RendererID, index, bindingPoint));
+}
+
+void Shader::SetUniform1i(UniformHandle uniform, int value)
+{
+    RenderStats::CountUniform();
+    GLCall(glUniform1i(uniform.location, value));
+}
+
+void Shader::SetUniform1ui(UniformHandle uniform, unsigned int value)
+{
+    RenderStats::CountUniform();
+    GLCall(glUniform1ui(uniform.location, value));
+}
+
+void Shader::SetUniform1f(UniformHandle uniform, float value)
+{
+    RenderStats::CountUniform();
+    GLCall(glUniform1f(uniform.location, value));
+}
+
+void Shader::SetUniform2f(UniformHandle uniform, const glm::vec2& value)
+{
+    RenderStats::CountUniform();
+    GLCall(glUniform2f(uniform.location, value.x, value.y));
+}
+
+void Shader::SetUniform4f(UniformHandle uniform, const glm::vec4& value)
+{
+    RenderStats::CountUniform();
+    GLCall(glUniform4f(uniform.location, value.x, value.y, value.z, value.w));
+}
+
+void Shader::SetUniform4fv(UniformHandle uniform, const glm::vec4* values, int count)
+{
+    RenderStats::CountUniform();
+    GLCall(glUniform4fv(uniform.location, count, &values[0].x));
+}
+
+void Shader::SetUniformMat4f(UniformHandle uniform, const glm::mat4& matrix)
+{
+    RenderStats::CountUniform();
+    GLCall(glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &matrix[0][0]));
+}
+
+void Shader::SetUniform1i(const std::string& name, int value)
+{
+    SetUniform1i(GetUniformHandle(name), value);
+}
+
+void Shader::SetUniform1f(const std::string& name, float value)
+{
+    SetUniform1f(GetUniformHandle(name), value);
+}
+
+void Shader::SetUniform4f(const std::string& name, const glm::vec4& value)
+{
+    SetUniform4f(GetUniformHandle(name), value);
+}
+
+void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
+{
+    SetUniformMat4f(GetUniformHandle(name), matrix);
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 struct ShaderProgramSource
 {
@@ -17,28 +18,68 @@ struct ShaderProgramSource
     std::string FragmentSource;
 };
 
+// Uniform location resolved once after the program is linked
+struct UniformHandle
+{
+    int location = -1;
+
+    inline bool IsValid() const { return location != -1; }
+};
+
 class Shader
 {
     private:
         std::string m_Filepath;
+        std::vector<std::string> m_Defines;
         unsigned int m_RendererID;
         std::unordered_map<std::string, int> m_UniformLocationCache;
+
+        // Startup statistics
+        double m_LoadTimeMs;
+        bool m_LoadedFromCache;
     public:
-        Shader(const std::string& filepath);
+        // Each define is injected as "#define <define>" into both stages,
+        // so one source file can produce several specialized programs
+        Shader(const std::string& filepath, const std::vector<std::string>& defines = {});
         ~Shader();
 
         void Bind() const;
         void Unbind() const;
 
-        // Set uniforms
+        // Time spent parsing, compiling and linking (or loading the cached binary)
+        inline double GetLoadTimeMs() const { return m_LoadTimeMs; }
+        inline bool WasLoadedFromCache() const { return m_LoadedFromCache; }
+
+        // Look up a uniform once (e.g. at load time) and keep the handle
+        UniformHandle GetUniformHandle(const std::string& name) const;
+
+        // Attach a uniform block to the binding point of a UniformBuffer
+        void BindUniformBlock(const std::string& blockName, unsigned int bindingPoint);
+
+        // Set uniforms (hot path, no lookups)
+        void SetUniform1i(UniformHandle uniform, int value);
+        void SetUniform1ui(UniformHandle uniform, unsigned int value);
+        void SetUniform1f(UniformHandle uniform, float value);
+        void SetUniform2f(UniformHandle uniform, const glm::vec2& value);
+        void SetUniform4f(UniformHandle uniform, const glm::vec4& value);
+        void SetUniform4fv(UniformHandle uniform, const glm::vec4* values, int count);
+        void SetUniformMat4f(UniformHandle uniform, const glm::mat4& matrix);
+
+        // Set uniforms by name (convenience, looks the handle up on every call)
         void SetUniform1i(const std::string& name, int value);
         void SetUniform1f(const std::string& name, float value);
-        void SetUniform4f(const std::string& name, glm::vec4& value);
+        void SetUniform4f(const std::string& name, const glm::vec4& value);
         void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
     private:
         ShaderProgramSource ParseShader(const std::string& filepath);
+        std::string InjectDefines(const std::string& source) const;
         unsigned int CompileShader(unsigned int type, const std::string& source);
         unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
 
-        int GetUniformLocation(const std::string& name);
+        // On-disk program binary cache, keyed by source and driver
+        std::string GetProgramCachePath(const ShaderProgramSource& source) const;
+        unsigned int LoadCachedProgram(const std::string& cachePath);
+        void SaveCachedProgram(unsigned int program, const std::string& cachePath);
+
+        void CacheUniformLocations();
 };
\ No newline at end of file
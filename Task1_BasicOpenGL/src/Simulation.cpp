@@ -0,0 +1,122 @@
+#include "Simulation.h"
+#include "Profiler.h"
+
+#include <chrono>
+
+// Steps later than this are dropped instead of being run back to back
+static const double MAX_LAG = 0.25;
+
+Simulation::Simulation(RubiksCube& cube, double stepsPerSecond)
+    : m_Step(1.0 / stepsPerSecond), m_Tick(0), m_Changed(true), m_Stopping(false)
+{
+    m_State.cube = &cube;
+
+    // Something to draw before the first step
+    cube.GetDrawData(m_Snapshots.GetBack().draws);
+    m_Snapshots.Publish();
+    m_Snapshots.Update();
+}
+
+Simulation::~Simulation()
+{
+    Stop();
+}
+
+void Simulation::Start()
+{
+    if (m_Thread.joinable())
+        return;
+
+    m_Stopping = false;
+    m_Thread = std::thread(&Simulation::Run, this);
+}
+
+void Simulation::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_CommandMutex);
+        m_Stopping = true;
+    }
+    m_CommandPosted.notify_one();
+    if (m_Thread.joinable())
+        m_Thread.join();
+}
+
+void Simulation::Advance(double time)
+{
+    while ((double)(m_Tick + 1) * m_Step <= time)
+        Step();
+}
+
+void Simulation::Post(Command command)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_CommandMutex);
+        m_Commands.push_back(std::move(command));
+    }
+    m_CommandPosted.notify_one();
+}
+
+bool Simulation::UpdateSnapshot()
+{
+    return m_Snapshots.Update();
+}
+
+void Simulation::Run()
+{
+    PROFILE_THREAD("simulation");
+    using Clock = std::chrono::steady_clock;
+    auto step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_Step));
+    auto next = Clock::now();
+
+    while (!m_Stopping)
+    {
+        Step();
+
+        // Idle: nothing to animate until more input comes in
+        if (!m_State.moves.IsTurning())
+        {
+            std::unique_lock<std::mutex> lock(m_CommandMutex);
+            m_CommandPosted.wait(lock, [this] { return m_Stopping || !m_Commands.empty(); });
+            next = Clock::now();
+            continue;
+        }
+
+        // Fixed rate: catch up after a slow step, unless it is hopeless
+        next += step;
+        auto now = Clock::now();
+        if (now - next > std::chrono::duration<double>(MAX_LAG))
+            next = now;
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void Simulation::Step()
+{
+    PROFILE_SCOPE("Simulation::Step");
+    {
+        std::lock_guard<std::mutex> lock(m_CommandMutex);
+        m_Running.swap(m_Commands);
+    }
+    for (auto& command : m_Running)
+        command(m_State);
+    m_Changed = m_Changed || !m_Running.empty();
+    m_Running.clear();
+
+    bool turning = m_State.moves.IsTurning();
+    m_State.moves.Update(*m_State.cube, (float)m_Step);
+    m_Tick++;
+
+    // Nothing moved since the last snapshot, the renderer still has it
+    if (!m_Changed && !turning)
+        return;
+
+    CubeSnapshot& snapshot = m_Snapshots.GetBack();
+    m_State.cube->GetDrawData(snapshot.draws, m_State.moves.GetTurns(), m_State.highlightedId);
+    snapshot.tick = m_Tick;
+    m_Snapshots.Publish();
+    m_Changed = false;
+
+    if (m_OnPublish)
+        m_OnPublish();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "MoveQueue.h"
+#include "RubiksCube.h"
+#include "TripleBuffer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// What the render thread gets to draw: immutable once published
+struct CubeSnapshot
+{
+    std::vector<CubieDrawData> draws;
+    uint64_t tick = 0; // simulation step it was taken at
+};
+
+// Owned by the simulation thread, only reached through Simulation::Post
+struct SimulationState
+{
+    RubiksCube* cube = nullptr;
+    MoveQueue moves;
+    int highlightedId = -1;
+};
+
+// Runs the cube on its own thread at a fixed time step: posted commands (input),
+// then the move animation, then a snapshot for the renderer. A slow step there
+// delays the next snapshot, never a frame; the render thread keeps drawing the
+// last one it has. With nothing turning the thread sleeps until the next Post.
+class Simulation
+{
+    private:
+        using Command = std::function<void(SimulationState&)>;
+
+        SimulationState m_State;
+        double m_Step; // seconds
+        uint64_t m_Tick;
+        bool m_Changed; // the next snapshot differs from the last one
+
+        std::mutex m_CommandMutex;
+        std::condition_variable m_CommandPosted;
+        std::vector<Command> m_Commands;
+        std::vector<Command> m_Running; // swapped with m_Commands each step
+
+        TripleBuffer<CubeSnapshot> m_Snapshots;
+        std::function<void()> m_OnPublish;
+        std::thread m_Thread;
+        std::atomic<bool> m_Stopping;
+
+        void Run();
+        void Step();
+    public:
+        // The cube belongs to the simulation until it is destroyed
+        Simulation(RubiksCube& cube, double stepsPerSecond = 120.0);
+        ~Simulation();
+
+        Simulation(const Simulation&) = delete;
+        Simulation& operator=(const Simulation&) = delete;
+
+        // Before Start the commands can set things up on the calling thread
+        void Start();
+        void Stop();
+        // Without the thread: runs every step due by time (seconds since the
+        // first step) on the calling thread, e.g. driven by a FixedClock
+        void Advance(double time);
+
+        // Runs on the simulation thread before its next step, in posting order
+        void Post(Command command);
+
+        // Called on the simulation thread after each new snapshot, e.g. to wake
+        // up a render loop waiting for events. Set before Start.
+        inline void SetPublishCallback(std::function<void()> callback) { m_OnPublish = std::move(callback); }
+
+        // Render thread: switches to the latest snapshot, true if it is new
+        bool UpdateSnapshot();
+        // Render thread: the snapshot taken by the last UpdateSnapshot
+        inline const CubeSnapshot& GetSnapshot() const { return m_Snapshots.GetFront(); }
+        // Direct access, only while the thread is not running
+        inline SimulationState& GetState() { return m_State; }
+        inline int GetCubeSize() const { return m_State.cube->GetSize(); }
+};
@@ -0,0 +1,263 @@
+#include "SoftwareRenderer.h"
+
+#include "CubeMesh.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFTWARE_RENDERER_SSE2
+#include <emmintrin.h>
+#endif
+
+// Same rounding as a GL_RGBA8 target
+static uint32_t PackColor(const glm::vec4& color)
+{
+    glm::vec4 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+    return (uint32_t)c.r | ((uint32_t)c.g << 8) | ((uint32_t)c.b << 16) | ((uint32_t)c.a << 24);
+}
+
+SoftwareRenderer::SoftwareRenderer(int width, int height, unsigned int threadCount)
+    : m_Width(std::max(1, width)), m_Height(std::max(1, height)), m_ClearColor(0), m_ClearPending(true),
+      m_Pool(threadCount)
+{
+    m_Stride = (m_Width + 3) & ~3;
+    m_TilesX = (m_Width + TILE_SIZE - 1) / TILE_SIZE;
+    m_TilesY = (m_Height + TILE_SIZE - 1) / TILE_SIZE;
+
+    m_Color.resize((size_t)m_Stride * m_Height);
+    m_Depth.resize((size_t)m_Stride * m_Height);
+    m_Bins.resize((size_t)m_TilesX * m_TilesY);
+}
+
+void SoftwareRenderer::Clear(const glm::vec4& color)
+{
+    m_ClearColor = PackColor(color);
+    m_ClearPending = true;
+}
+
+void SoftwareRenderer::Draw(const RubiksCube& cube, const glm::mat4& viewProj, const glm::mat4& globalModel,
+                            const std::vector<LayerTurn>& turns, int highlightedId)
+{
+    unsigned int vertexCount, indexCount;
+    const CubeVertex* vertices = CubeMesh::GetVertexData(vertexCount);
+    const unsigned short* indices = CubeMesh::GetIndexData(indexCount);
+
+    glm::mat4 frame = viewProj * globalModel;
+
+    // 1. Geometry: same transform as basic.shader, one triangle setup per face half
+    m_Triangles.clear();
+    cube.GetDrawData(m_DrawData, turns, highlightedId);
+
+    glm::vec4 clip[24];
+    for (const auto& draw : m_DrawData)
+    {
+        glm::mat4 mvp = frame * draw.model;
+        for (unsigned int v = 0; v < vertexCount && v < 24; v++)
+        {
+            // snorm8 positions, 127 is exactly 1.0
+            const signed char* p = vertices[v].position;
+            clip[v] = mvp * glm::vec4(p[0] / 127.0f, p[1] / 127.0f, p[2] / 127.0f, 1.0f);
+        }
+
+        uint32_t colors[6];
+        for (int f = 0; f < 6; f++)
+            colors[f] = PackColor(draw.faceColors[f]);
+
+        for (unsigned int i = 0; i + 2 < indexCount; i += 3)
+        {
+            const glm::vec4 triangle[3] = { clip[indices[i]], clip[indices[i + 1]], clip[indices[i + 2]] };
+            SetupTriangle(triangle, colors[vertices[indices[i + 2]].face]);
+        }
+    }
+
+    // 2. Binning, triangle order is kept so depth ties resolve like GL_LESS
+    for (auto& bin : m_Bins)
+        bin.clear();
+
+    for (uint32_t t = 0; t < (uint32_t)m_Triangles.size(); t++)
+    {
+        const Triangle& tri = m_Triangles[t];
+        for (int ty = tri.minY / TILE_SIZE; ty <= tri.maxY / TILE_SIZE; ty++)
+            for (int tx = tri.minX / TILE_SIZE; tx <= tri.maxX / TILE_SIZE; tx++)
+                m_Bins[ty * m_TilesX + tx].push_back(t);
+    }
+
+    // 3. Tiles never share pixels, so they need no synchronization
+    for (int ty = 0; ty < m_TilesY; ty++)
+        for (int tx = 0; tx < m_TilesX; tx++)
+            m_Pool.Submit([this, tx, ty] { RasterizeTile(tx, ty); });
+    m_Pool.Wait();
+
+    m_ClearPending = false;
+}
+
+void SoftwareRenderer::SetupTriangle(const glm::vec4 clip[3], uint32_t color)
+{
+    // No clipping: triangles crossing the near or far plane are dropped
+    // (the cube never gets that close to the camera)
+    for (int i = 0; i < 3; i++)
+        if (clip[i].w <= 0.0f || clip[i].z < -clip[i].w || clip[i].z > clip[i].w)
+            return;
+
+    // Window coordinates with y down, so row 0 is the top of the image
+    glm::vec3 v[3];
+    for (int i = 0; i < 3; i++)
+    {
+        glm::vec3 ndc = glm::vec3(clip[i]) / clip[i].w;
+        v[i] = glm::vec3((ndc.x * 0.5f + 0.5f) * m_Width, (0.5f - ndc.y * 0.5f) * m_Height, ndc.z * 0.5f + 0.5f);
+    }
+
+    // Counter-clockwise (GL front face) comes out negative with y down
+    float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+    if (area >= 0.0f)
+        return;
+    std::swap(v[1], v[2]);
+    area = -area;
+
+    Triangle tri;
+    tri.minX = std::max(0, (int)std::floor(std::min({ v[0].x, v[1].x, v[2].x })));
+    tri.minY = std::max(0, (int)std::floor(std::min({ v[0].y, v[1].y, v[2].y })));
+    tri.maxX = std::min(m_Width - 1, (int)std::ceil(std::max({ v[0].x, v[1].x, v[2].x })));
+    tri.maxY = std::min(m_Height - 1, (int)std::ceil(std::max({ v[0].y, v[1].y, v[2].y })));
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY)
+        return;
+
+    for (int e = 0; e < 3; e++)
+    {
+        const glm::vec3& a = v[e];
+        const glm::vec3& b = v[(e + 1) % 3];
+
+        // Evaluate every edge from its lower endpoint. A shared edge then gives
+        // exactly opposite values in both triangles, which keeps the mesh watertight.
+        bool forward = (a.x < b.x) || (a.x == b.x && a.y < b.y);
+        const glm::vec3& lo = forward ? a : b;
+        const glm::vec3& hi = forward ? b : a;
+        float sign = forward ? 1.0f : -1.0f;
+
+        tri.edgeA[e] = sign * (lo.y - hi.y);
+        tri.edgeB[e] = sign * (hi.x - lo.x);
+        tri.edgeX[e] = lo.x;
+        tri.edgeY[e] = lo.y;
+        // Left edges (inside to the right) and top edges (inside below)
+        tri.topLeft[e] = tri.edgeA[e] > 0.0f || (tri.edgeA[e] == 0.0f && tri.edgeB[e] > 0.0f);
+    }
+
+    float dx1 = v[1].x - v[0].x, dy1 = v[1].y - v[0].y, dz1 = v[1].z - v[0].z;
+    float dx2 = v[2].x - v[0].x, dy2 = v[2].y - v[0].y, dz2 = v[2].z - v[0].z;
+    tri.z = v[0].z;
+    tri.dzdx = (dz1 * dy2 - dz2 * dy1) / area;
+    tri.dzdy = (dx1 * dz2 - dx2 * dz1) / area;
+    tri.originX = v[0].x;
+    tri.originY = v[0].y;
+    tri.color = color;
+
+    m_Triangles.push_back(tri);
+}
+
+void SoftwareRenderer::RasterizeTile(int tileX, int tileY)
+{
+    int x0 = tileX * TILE_SIZE, y0 = tileY * TILE_SIZE;
+    int x1 = std::min(x0 + TILE_SIZE, m_Width) - 1;
+    int y1 = std::min(y0 + TILE_SIZE, m_Height) - 1;
+
+    if (m_ClearPending)
+    {
+        for (int y = y0; y <= y1; y++)
+        {
+            std::fill_n(&m_Color[(size_t)y * m_Stride + x0], x1 - x0 + 1, m_ClearColor);
+            std::fill_n(&m_Depth[(size_t)y * m_Stride + x0], x1 - x0 + 1, 1.0f);
+        }
+    }
+
+    for (uint32_t index : m_Bins[tileY * m_TilesX + tileX])
+    {
+        const Triangle& tri = m_Triangles[index];
+        int minX = std::max(tri.minX, x0), maxX = std::min(tri.maxX, x1);
+        int minY = std::max(tri.minY, y0), maxY = std::min(tri.maxY, y1);
+
+#ifdef SOFTWARE_RENDERER_SSE2
+        __m128 edgeA[3], edgeX[3], topLeft[3];
+        for (int e = 0; e < 3; e++)
+        {
+            edgeA[e] = _mm_set1_ps(tri.edgeA[e]);
+            edgeX[e] = _mm_set1_ps(tri.edgeX[e]);
+            topLeft[e] = _mm_castsi128_ps(_mm_set1_epi32(tri.topLeft[e] ? -1 : 0));
+        }
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 lane = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+        const __m128 firstX = _mm_set1_ps((float)minX), lastX = _mm_set1_ps((float)maxX);
+        const __m128 dzdx = _mm_set1_ps(tri.dzdx);
+        const __m128 originX = _mm_set1_ps(tri.originX);
+        const __m128i color = _mm_set1_epi32((int)tri.color);
+
+        // 4 pixels at a time, from a 4-aligned column (rows are padded to a multiple of 4)
+        int startX = minX & ~3;
+        for (int y = minY; y <= maxY; y++)
+        {
+            float py = y + 0.5f;
+            __m128 rowE[3];
+            for (int e = 0; e < 3; e++)
+                rowE[e] = _mm_set1_ps(tri.edgeB[e] * (py - tri.edgeY[e]));
+            __m128 rowZ = _mm_set1_ps(tri.z + tri.dzdy * (py - tri.originY));
+
+            uint32_t* colorRow = &m_Color[(size_t)y * m_Stride];
+            float* depthRow = &m_Depth[(size_t)y * m_Stride];
+
+            for (int x = startX; x <= maxX; x += 4)
+            {
+                __m128 column = _mm_add_ps(_mm_set1_ps((float)x), lane);
+                __m128 px = _mm_add_ps(column, _mm_set1_ps(0.5f));
+                __m128 mask = _mm_and_ps(_mm_cmpge_ps(column, firstX), _mm_cmple_ps(column, lastX));
+
+                for (int e = 0; e < 3; e++)
+                {
+                    __m128 E = _mm_add_ps(_mm_mul_ps(edgeA[e], _mm_sub_ps(px, edgeX[e])), rowE[e]);
+                    __m128 inside = _mm_or_ps(_mm_cmpgt_ps(E, zero), _mm_and_ps(_mm_cmpeq_ps(E, zero), topLeft[e]));
+                    mask = _mm_and_ps(mask, inside);
+                }
+                if (_mm_movemask_ps(mask) == 0)
+                    continue;
+
+                __m128 z = _mm_add_ps(rowZ, _mm_mul_ps(dzdx, _mm_sub_ps(px, originX)));
+                __m128 depth = _mm_loadu_ps(depthRow + x);
+                mask = _mm_and_ps(mask, _mm_cmplt_ps(z, depth));
+
+                _mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(mask, z), _mm_andnot_ps(mask, depth)));
+                __m128i maskI = _mm_castps_si128(mask);
+                __m128i dst = _mm_loadu_si128((const __m128i*)(colorRow + x));
+                _mm_storeu_si128((__m128i*)(colorRow + x), _mm_or_si128(_mm_and_si128(maskI, color), _mm_andnot_si128(maskI, dst)));
+            }
+        }
+#else
+        for (int y = minY; y <= maxY; y++)
+        {
+            float py = y + 0.5f;
+            uint32_t* colorRow = &m_Color[(size_t)y * m_Stride];
+            float* depthRow = &m_Depth[(size_t)y * m_Stride];
+
+            for (int x = minX; x <= maxX; x++)
+            {
+                float px = x + 0.5f;
+                bool inside = true;
+                for (int e = 0; e < 3 && inside; e++)
+                {
+                    float E = tri.edgeA[e] * (px - tri.edgeX[e]) + tri.edgeB[e] * (py - tri.edgeY[e]);
+                    inside = E > 0.0f || (E == 0.0f && tri.topLeft[e]);
+                }
+                if (!inside)
+                    continue;
+
+                float z = (tri.z + tri.dzdy * (py - tri.originY)) + tri.dzdx * (px - tri.originX);
+                if (z < depthRow[x])
+                {
+                    depthRow[x] = z;
+                    colorRow[x] = tri.color;
+                }
+            }
+        }
+#endif
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "RubiksCube.h"
+#include "WorkerPool.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// CPU renderer for cube states, for machines without any GL. Uses the CubeMesh
+// geometry and the colors of RubiksCube::GetDrawData, so images match CubeRenderer::Draw
+// with the same view-projection matrix (flat colors only, no sticker texture).
+// Triangles are binned into tiles which are rasterized in parallel on a
+// WorkerPool, with SSE2 edge functions where available.
+class SoftwareRenderer
+{
+    private:
+        // Screen space triangle, edges are E = A * (x - X) + B * (y - Y), inside when E >= 0
+        struct Triangle
+        {
+            float edgeA[3], edgeB[3], edgeX[3], edgeY[3];
+            bool topLeft[3];  // E == 0 counts as inside (fill rule for shared edges)
+            float z, dzdx, dzdy, originX, originY; // depth plane
+            int minX, minY, maxX, maxY;
+            uint32_t color;
+        };
+
+        int m_Width, m_Height;
+        int m_Stride;     // pixels per row, a multiple of 4 so SIMD rows never run past it
+        int m_TilesX, m_TilesY;
+        std::vector<uint32_t> m_Color; // RGBA8, top row first
+        std::vector<float> m_Depth;
+        uint32_t m_ClearColor;
+        bool m_ClearPending;
+
+        std::vector<Triangle> m_Triangles;
+        std::vector<std::vector<uint32_t>> m_Bins; // triangle indices per tile, in draw order
+        std::vector<CubieDrawData> m_DrawData;
+        WorkerPool m_Pool;
+    public:
+        // threadCount 0 = one per hardware thread
+        SoftwareRenderer(int width, int height, unsigned int threadCount = 0);
+
+        SoftwareRenderer(const SoftwareRenderer&) = delete;
+        SoftwareRenderer& operator=(const SoftwareRenderer&) = delete;
+
+        // Applied by the next Draw, tile by tile
+        void Clear(const glm::vec4& color);
+
+        // Same parameters as RubiksCube::Draw
+        void Draw(const RubiksCube& cube, const glm::mat4& viewProj, const glm::mat4& globalModel,
+                  const std::vector<LayerTurn>& turns = {}, int highlightedId = -1);
+
+        // RGBA8 rows, top row first, GetStride() bytes apart
+        inline const unsigned char* GetPixels() const { return (const unsigned char*)m_Color.data(); }
+        inline int GetStride() const { return m_Stride * 4; }
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+
+        static const int TILE_SIZE = 64;
+    private:
+        void SetupTriangle(const glm::vec4 clip[3], uint32_t color);
+        void RasterizeTile(int tileX, int tileY);
+};
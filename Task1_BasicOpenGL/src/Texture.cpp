@@ -2,20 +2,56 @@
 #include <stb/stb_image_write.h>
 
 #include <Texture.h>
+#include <GLExtensions.h>
+#include <Profiler.h>
+#include <RenderStats.h>
+
+#include <filesystem>
 
 Texture::Texture(const std::string& filepath)
     : m_RendererID(0), m_Filepath(filepath), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_Components(0)
 {
+    CreateTexture();
+
+    // Compressed textures upload as they are, with their own mipmaps
+    KtxImage compressed;
+    std::string compressedPath = GetCompressedPath(filepath);
+    if (std::filesystem::exists(compressedPath) && LoadKtx2(compressedPath, compressed) &&
+        GetCompressedFormat(compressed.format) != 0)
+    {
+        SetCompressedImage(compressed, compressed.data.data());
+        return;
+    }
+
     // Flips the image so it appears right side up
     stbi_set_flip_vertically_on_load(1);
 
     // Reads the image from a file and stores it in m_LocalBuffer
     m_LocalBuffer = stbi_load(filepath.c_str(), &m_Width, &m_Height, &m_Components, 4);
 
+    SetImage(m_Width, m_Height, m_LocalBuffer);
+
+    if (m_LocalBuffer)
+    {
+        // Deletes the image data as it is already in the OpenGL Texture object
+        stbi_image_free(m_LocalBuffer);
+    }
+}
+
+Texture::Texture(int width, int height, const void* pixels)
+    : m_RendererID(0), m_LocalBuffer(nullptr), m_Width(width), m_Height(height), m_Components(4)
+{
+    CreateTexture();
+    SetImage(width, height, pixels);
+}
+
+void Texture::CreateTexture()
+{
     // Generates an OpenGL texture object
     GLCall(glGenTextures(1, &m_RendererID));
 
     // Assigns the texture to a Texture Unit
+    RenderStats::CountBind(BindTarget::Texture2D, m_RendererID);
     GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
 
     // Configures the type of algorithm that is used to make the image smaller or bigger
@@ -26,34 +62,92 @@ Texture::Texture(const std::string& filepath)
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
 	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
 
+    RenderStats::CountBind(BindTarget::Texture2D, 0);
+    GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+void Texture::SetImage(int width, int height, const void* pixels)
+{
+    PROFILE_SCOPE("Texture::SetImage");
+    m_Width = width;
+    m_Height = height;
+
+    RenderStats::CountBind(BindTarget::Texture2D, m_RendererID);
+    GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+
     // Assigns the image to the OpenGL Texture object
-    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+    RenderStats::CountTextureUpload((size_t)m_Width * m_Height * 4);
 
-    // Generates Mipmaps
+    // Generates Mipmaps (a compressed image before may have limited the chain)
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000));
 	GLCall(glGenerateMipmap(GL_TEXTURE_2D));
 
     // Unbinds the OpenGL Texture object so that it can't accidentally be modified
+    RenderStats::CountBind(BindTarget::Texture2D, 0);
     GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+}
 
-    if (m_LocalBuffer)
+void Texture::SetCompressedImage(const KtxImage& image, const unsigned char* data)
+{
+    PROFILE_SCOPE("Texture::SetCompressedImage");
+    m_Width = image.width;
+    m_Height = image.height;
+    GLenum format = GetCompressedFormat(image.format);
+
+    RenderStats::CountBind(BindTarget::Texture2D, m_RendererID);
+    GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+
+    for (size_t i = 0; i < image.levels.size(); i++)
     {
-        // Deletes the image data as it is already in the OpenGL Texture object
-        stbi_image_free(m_LocalBuffer);
+        const KtxLevel& level = image.levels[i];
+        GLCall(glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)i, format, level.width, level.height, 0,
+                                      (GLsizei)level.size, data + level.offset));
+        RenderStats::CountTextureUpload(level.size);
     }
+
+    // The file may stop before 1x1, sample only the levels it has
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)image.levels.size() - 1));
+
+    RenderStats::CountBind(BindTarget::Texture2D, 0);
+    GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+unsigned int Texture::GetCompressedFormat(KtxFormat format)
+{
+    switch (format)
+    {
+    case KtxFormat::BC1_RGB:   return GLExt_TextureS3TC ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : 0;
+    case KtxFormat::BC1_RGBA:  return GLExt_TextureS3TC ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT : 0;
+    case KtxFormat::BC3_RGBA:  return GLExt_TextureS3TC ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : 0;
+    case KtxFormat::BC7_RGBA:  return GLExt_TextureBPTC ? GL_COMPRESSED_RGBA_BPTC_UNORM : 0;
+    case KtxFormat::ETC2_RGB:  return GLExt_TextureETC2 ? GL_COMPRESSED_RGB8_ETC2 : 0;
+    case KtxFormat::ETC2_RGBA: return GLExt_TextureETC2 ? GL_COMPRESSED_RGBA8_ETC2_EAC : 0;
+    default:                   return 0;
+    }
+}
+
+std::string Texture::GetCompressedPath(const std::string& filepath)
+{
+    return std::filesystem::path(filepath).replace_extension(".ktx2").string();
 }
 
 Texture::~Texture()
 {
+    RenderStats::CountDelete(BindTarget::Texture2D, m_RendererID);
     GLCall(glDeleteTextures(1, &m_RendererID));
 }
 
 void Texture::Bind(unsigned int slot) const
 {
+    RenderStats::CountActiveTexture(slot);
     GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+    RenderStats::CountBind(BindTarget::Texture2D, m_RendererID);
     GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
 }
 
 void Texture::Unbind() const
 {
+    RenderStats::CountBind(BindTarget::Texture2D, 0);
     GLCall(glBindTexture(GL_TEXTURE_2D, 0));
 }
\ No newline at end of file
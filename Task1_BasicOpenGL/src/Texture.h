@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Debugger.h>
+#include <KtxImage.h>
 
 #include <iostream>
 #include <string>
@@ -13,12 +14,35 @@ class Texture
         unsigned char* m_LocalBuffer;
         int m_Width, m_Height, m_Components;
     public:
+        // Prefers a compressed copy next to the file (same name, .ktx2) when
+        // the GL supports its format, otherwise decodes the file itself
         Texture(const std::string& filepath);
+        // RGBA8 image from memory, pixels may be null
+        Texture(int width, int height, const void* pixels);
         ~Texture();
 
+        Texture(const Texture&) = delete;
+        Texture& operator=(const Texture&) = delete;
+
+        // Replaces the image (RGBA8) and rebuilds the mipmaps. With a buffer bound
+        // to GL_PIXEL_UNPACK_BUFFER, pixels is an offset into that buffer.
+        void SetImage(int width, int height, const void* pixels);
+
+        // Replaces the image with all the levels of a compressed one. data points at
+        // image.data, or is null to read the levels from a bound GL_PIXEL_UNPACK_BUFFER.
+        void SetCompressedImage(const KtxImage& image, const unsigned char* data);
+
         void Bind(unsigned int slot = 0) const;
         void Unbind() const;
 
         inline int GetWidth() const { return m_Width; }
         inline int GetHeight() const { return m_Height; }
+        inline const std::string& GetFilepath() const { return m_Filepath; }
+
+        // GL internal format for a compressed format, 0 if this context can't sample it
+        static unsigned int GetCompressedFormat(KtxFormat format);
+        // "textures/plane.png" -> "textures/plane.ktx2"
+        static std::string GetCompressedPath(const std::string& filepath);
+    private:
+        void CreateTexture();
 };
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include <TextureArray.h>
+#include <Profiler.h>
+#include <RenderStats.h>
+
+#include <stb/stb_image.h>
+
+#include <algorithm>
+
+TextureArray::TextureArray(const std::vector<std::string>& filepaths, int width, int height)
+    : m_RendererID(0), m_Width(width), m_Height(height), m_Layers((int)filepaths.size())
+{
+    PROFILE_SCOPE("TextureArray::TextureArray");
+    GLCall(glGenTextures(1, &m_RendererID));
+    RenderStats::CountBind(BindTarget::Texture2DArray, m_RendererID);
+    GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, m_RendererID));
+
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    // Clamp so a sticker never samples its neighbour's edge
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+    GLCall(glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, m_Width, m_Height, m_Layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+
+    std::vector<unsigned char> layer((size_t)m_Width * m_Height * 4);
+    stbi_set_flip_vertically_on_load(1);
+
+    for (int i = 0; i < m_Layers; i++)
+    {
+        int w, h, components;
+        unsigned char* pixels = stbi_load(filepaths[i].c_str(), &w, &h, &components, 4);
+        if (!pixels)
+        {
+            std::cout << "Failed to load " << filepaths[i] << ": " << stbi_failure_reason() << std::endl;
+            std::fill(layer.begin(), layer.end(), 255);
+        }
+        else
+        {
+            // Nearest-neighbour resample, layers must share one size
+            for (int y = 0; y < m_Height; y++)
+            {
+                const unsigned char* src = pixels + (size_t)(y * h / m_Height) * w * 4;
+                unsigned char* dst = layer.data() + (size_t)y * m_Width * 4;
+                for (int x = 0; x < m_Width; x++)
+                    std::copy_n(src + (size_t)(x * w / m_Width) * 4, 4, dst + (size_t)x * 4);
+            }
+            stbi_image_free(pixels);
+        }
+
+        GLCall(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, m_Width, m_Height, 1, GL_RGBA, GL_UNSIGNED_BYTE, layer.data()));
+        RenderStats::CountTextureUpload(layer.size());
+    }
+
+    GLCall(glGenerateMipmap(GL_TEXTURE_2D_ARRAY));
+    RenderStats::CountBind(BindTarget::Texture2DArray, 0);
+    GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+}
+
+TextureArray::~TextureArray()
+{
+    RenderStats::CountDelete(BindTarget::Texture2DArray, m_RendererID);
+    GLCall(glDeleteTextures(1, &m_RendererID));
+}
+
+void TextureArray::Bind(unsigned int slot) const
+{
+    RenderStats::CountActiveTexture(slot);
+    GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+    RenderStats::CountBind(BindTarget::Texture2DArray, m_RendererID);
+    GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, m_RendererID));
+}
+
+void TextureArray::Unbind() const
+{
+    RenderStats::CountBind(BindTarget::Texture2DArray, 0);
+    GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+}
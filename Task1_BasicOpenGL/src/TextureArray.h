@@ -0,0 +1,29 @@
+#pragma once
+
+#include <Debugger.h>
+
+#include <string>
+#include <vector>
+
+// GL_TEXTURE_2D_ARRAY with one RGBA8 image per layer, all the same size
+class TextureArray
+{
+    private:
+        unsigned int m_RendererID;
+        int m_Width, m_Height, m_Layers;
+    public:
+        // One layer per file, each resampled to width x height if needed.
+        // Files that fail to load leave a white layer.
+        TextureArray(const std::vector<std::string>& filepaths, int width, int height);
+        ~TextureArray();
+
+        TextureArray(const TextureArray&) = delete;
+        TextureArray& operator=(const TextureArray&) = delete;
+
+        void Bind(unsigned int slot = 0) const;
+        void Unbind() const;
+
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+        inline int GetLayerCount() const { return m_Layers; }
+};
@@ -0,0 +1,125 @@
+#include <TextureCache.h>
+#include <Profiler.h>
+
+#include <stb/stb_image.h>
+
+#include <cstring>
+#include <filesystem>
+
+TextureCache::TextureCache(unsigned int decodeThreads, size_t uploadBudget)
+    : m_UploadBuffer(0), m_UploadBudget(uploadBudget), m_Pending(0), m_Decoder(decodeThreads)
+{
+    GLCall(glGenBuffers(1, &m_UploadBuffer));
+}
+
+TextureCache::~TextureCache()
+{
+    // Let running decodes finish before their results are freed
+    m_Decoder.Wait();
+    for (auto& image : m_Decoded)
+        stbi_image_free(image.pixels);
+
+    GLCall(glDeleteBuffers(1, &m_UploadBuffer));
+}
+
+TextureHandle TextureCache::Load(const std::string& filepath)
+{
+    TextureHandle texture = m_Textures[filepath].lock();
+    if (texture)
+        return texture;
+
+    const unsigned char white[4] = { 255, 255, 255, 255 };
+    texture = std::make_shared<Texture>(1, 1, white);
+    m_Textures[filepath] = texture;
+    m_Pending++;
+
+    std::weak_ptr<Texture> target = texture;
+    m_Decoder.Submit([this, filepath, target]
+    {
+        DecodedImage image;
+        image.path = filepath;
+        image.texture = target;
+
+        // Compressed files need no decoding, only reading
+        std::string compressedPath = Texture::GetCompressedPath(filepath);
+        if (std::filesystem::exists(compressedPath) && LoadKtx2(compressedPath, image.compressed) &&
+            Texture::GetCompressedFormat(image.compressed.format) != 0)
+        {
+            std::lock_guard<std::mutex> lock(m_DecodedMutex);
+            m_Decoded.push_back(std::move(image));
+            return;
+        }
+        image.compressed = KtxImage();
+
+        // Per-thread setting, the flag of the GL thread stays untouched
+        stbi_set_flip_vertically_on_load_thread(1);
+        int components;
+        image.pixels = stbi_load(filepath.c_str(), &image.width, &image.height, &components, 4);
+        if (!image.pixels)
+            image.error = stbi_failure_reason();
+
+        std::lock_guard<std::mutex> lock(m_DecodedMutex);
+        m_Decoded.push_back(std::move(image));
+    });
+
+    return texture;
+}
+
+size_t TextureCache::GetUploadSize(const DecodedImage& image)
+{
+    if (!image.compressed.levels.empty())
+        return image.compressed.data.size();
+    return (size_t)image.width * image.height * 4;
+}
+
+void TextureCache::Update()
+{
+    PROFILE_SCOPE("TextureCache::Update");
+    std::vector<DecodedImage> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_DecodedMutex);
+        if (m_Decoded.empty())
+            return;
+
+        // Stay within the budget, the rest waits for the next frame
+        size_t bytes = 0, count = 0;
+        while (count < m_Decoded.size() && (count == 0 || bytes < m_UploadBudget))
+        {
+            bytes += GetUploadSize(m_Decoded[count]);
+            count++;
+        }
+
+        ready.assign(std::make_move_iterator(m_Decoded.begin()), std::make_move_iterator(m_Decoded.begin() + count));
+        m_Decoded.erase(m_Decoded.begin(), m_Decoded.begin() + count);
+    }
+
+    for (auto& image : ready)
+    {
+        m_Pending--;
+        TextureHandle texture = image.texture.lock();
+
+        bool compressed = !image.compressed.levels.empty();
+        if (!image.pixels && !compressed)
+            std::cout << "Failed to load texture " << image.path << ": " << image.error << std::endl;
+        else if (texture)
+        {
+            // Orphan the buffer, fill it, and let the driver copy from it asynchronously
+            size_t size = GetUploadSize(image);
+            GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_UploadBuffer));
+            GLCall(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+            GLCall(void* data = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+            if (data)
+            {
+                std::memcpy(data, compressed ? image.compressed.data.data() : image.pixels, size);
+                GLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+                if (compressed)
+                    texture->SetCompressedImage(image.compressed, nullptr);
+                else
+                    texture->SetImage(image.width, image.height, nullptr);
+            }
+            GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+        }
+
+        stbi_image_free(image.pixels);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Texture.h"
+#include "WorkerPool.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using TextureHandle = std::shared_ptr<Texture>;
+
+// Shares textures by path. Load returns at once with a 1x1 white placeholder
+// (so textured draws look like flat ones); the file is decoded on a worker
+// thread and Update uploads it into the same Texture through a pixel buffer.
+// Like Texture, a supported .ktx2 next to the file is used instead of it.
+// A texture is freed when the last handle goes away.
+class TextureCache
+{
+    private:
+        // Finished decode, waiting for the GL thread
+        struct DecodedImage
+        {
+            std::string path;
+            std::weak_ptr<Texture> texture;
+            int width = 0, height = 0;
+            unsigned char* pixels = nullptr; // stbi allocation, null if decoding failed
+            KtxImage compressed;             // used instead when it has levels
+            std::string error;
+        };
+
+        std::unordered_map<std::string, std::weak_ptr<Texture>> m_Textures;
+        std::vector<DecodedImage> m_Decoded;
+        std::mutex m_DecodedMutex;
+        unsigned int m_UploadBuffer;
+        size_t m_UploadBudget;
+        int m_Pending;
+        WorkerPool m_Decoder;
+
+        static size_t GetUploadSize(const DecodedImage& image);
+    public:
+        // uploadBudget: bytes uploaded per Update at most (one image always goes through)
+        TextureCache(unsigned int decodeThreads = 1, size_t uploadBudget = 16 * 1024 * 1024);
+        ~TextureCache();
+
+        TextureCache(const TextureCache&) = delete;
+        TextureCache& operator=(const TextureCache&) = delete;
+
+        // Never blocks on file I/O
+        TextureHandle Load(const std::string& filepath);
+
+        // Call once per frame on the GL thread
+        void Update();
+
+        // Textures still decoding or waiting for upload
+        inline int GetPendingCount() const { return m_Pending; }
+};
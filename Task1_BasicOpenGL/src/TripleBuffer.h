@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Hands the latest value from one writer thread to one reader thread without
+// locks: the writer fills its back slot and swaps it with the middle one, the
+// reader swaps the middle slot for its front one when a new value is there.
+// Neither side ever waits, and the reader only sees complete values.
+template<typename T>
+class TripleBuffer
+{
+    private:
+        // Middle slot index, with NEW_BIT set while the reader has not taken it
+        static const uint8_t NEW_BIT = 4;
+
+        T m_Slots[3];
+        std::atomic<uint8_t> m_Middle;
+        uint8_t m_Back;  // writer only
+        uint8_t m_Front; // reader only
+    public:
+        TripleBuffer() : m_Middle(1), m_Back(0), m_Front(2) {}
+
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        // Writer: the slot to fill, may hold any older value
+        inline T& GetBack() { return m_Slots[m_Back]; }
+        // Writer: makes the back slot the latest value
+        void Publish()
+        {
+            uint8_t previous = m_Middle.exchange(m_Back | NEW_BIT, std::memory_order_acq_rel);
+            m_Back = previous & ~NEW_BIT;
+        }
+
+        // Reader: switches to the latest value if there is a newer one, true if so
+        bool Update()
+        {
+            if (!(m_Middle.load(std::memory_order_relaxed) & NEW_BIT))
+                return false;
+
+            uint8_t previous = m_Middle.exchange(m_Front, std::memory_order_acq_rel);
+            m_Front = previous & ~NEW_BIT;
+            return true;
+        }
+        // Reader: the value taken by the last Update
+        inline const T& GetFront() const { return m_Slots[m_Front]; }
+};
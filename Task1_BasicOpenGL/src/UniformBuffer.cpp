@@ -0,0 +1,49 @@
+#include <UniformBuffer.h>
+#include <Profiler.h>
+#include <RenderStats.h>
+
+UniformBuffer::UniformBuffer(unsigned int size, unsigned int bindingPoint)
+    : m_RendererID(0), m_Size(size), m_BindingPoint(bindingPoint)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    Bind();
+    GLCall(glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+
+    // The buffer stays attached to its binding point, shaders only refer to the index
+    BindBase();
+    Unbind();
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    RenderStats::CountDelete(BindTarget::UniformBuffer, m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void UniformBuffer::SetData(const void* data, unsigned int size, unsigned int offset)
+{
+    PROFILE_SCOPE("UniformBuffer::SetData");
+    ASSERT(offset + size <= m_Size);
+
+    Bind();
+    GLCall(glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data));
+    RenderStats::CountBufferUpload(size);
+}
+
+void UniformBuffer::Bind() const
+{
+    RenderStats::CountBind(BindTarget::UniformBuffer, m_RendererID);
+    GLCall(glBindBuffer(GL_UNIFORM_BUFFER, m_RendererID));
+}
+
+void UniformBuffer::BindBase() const
+{
+    RenderStats::CountBindBase(m_BindingPoint, m_RendererID);
+    GLCall(glBindBufferBase(GL_UNIFORM_BUFFER, m_BindingPoint, m_RendererID));
+}
+
+void UniformBuffer::Unbind() const
+{
+    RenderStats::CountBind(BindTarget::UniformBuffer, 0);
+    GLCall(glBindBuffer(GL_UNIFORM_BUFFER, 0));
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Debugger.h>
+
+// UBO
+class UniformBuffer
+{
+    private:
+        unsigned int m_RendererID;
+        unsigned int m_Size;
+        unsigned int m_BindingPoint;
+    public:
+        UniformBuffer(unsigned int size, unsigned int bindingPoint);
+        ~UniformBuffer();
+
+        // Overwrites a range of the buffer, the whole buffer by default
+        void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+
+        void Bind() const;
+        // Attaches the buffer to its binding point again, needed when several
+        // buffers (e.g. one per RubiksCube) share the same binding point
+        void BindBase() const;
+        void Unbind() const;
+
+        inline unsigned int GetBindingPoint() const { return m_BindingPoint; }
+};
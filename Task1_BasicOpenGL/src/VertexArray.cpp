@@ -1,5 +1,6 @@
 #include <VertexArray.h>
 #include <VertexBufferLayout.h>
+#include <RenderStats.h>
 
 VertexArray::VertexArray()
 {
@@ -8,10 +9,12 @@ VertexArray::VertexArray()
 
 VertexArray::~VertexArray()
 {
+    RenderStats::CountDelete(BindTarget::VertexArray, m_RendererID);
     GLCall(glDeleteVertexArrays(1, &m_RendererID));
 }
         
-void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout)
+void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout,
+                            unsigned int firstIndex, unsigned int divisor)
 {
     Bind();
     vb.Bind();
@@ -20,18 +23,32 @@ void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& la
     for (unsigned int i = 0; i < elements.size(); i ++)
     {
         const auto& element = elements[i];
-        GLCall(glEnableVertexAttribArray(i));
-        GLCall(glVertexAttribPointer(i, element.count, element.type, element.normalized, layout.GetStride(), (const void*) (uintptr_t) offset));
+        unsigned int index = firstIndex + i;
+        GLCall(glEnableVertexAttribArray(index));
+        if (element.integer)
+        {
+            GLCall(glVertexAttribIPointer(index, element.count, element.type, layout.GetStride(), (const void*) (uintptr_t) offset));
+        }
+        else
+        {
+            GLCall(glVertexAttribPointer(index, element.count, element.type, element.normalized, layout.GetStride(), (const void*) (uintptr_t) offset));
+        }
+        if (divisor != 0)
+        {
+            GLCall(glVertexAttribDivisor(index, divisor));
+        }
         offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
     }
 }
 
 void VertexArray::Bind() const
 {
+    RenderStats::CountBind(BindTarget::VertexArray, m_RendererID);
     GLCall(glBindVertexArray(m_RendererID));
 }
 
 void VertexArray::Unbind() const
 {
+    RenderStats::CountBind(BindTarget::VertexArray, 0);
     GLCall(glBindVertexArray(0));
 }
\ No newline at end of file
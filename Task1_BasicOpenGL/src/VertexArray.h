@@ -13,7 +13,9 @@ class VertexArray
         VertexArray();
         ~VertexArray();
         
-        void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+        // Attributes are numbered from firstIndex. divisor 1 = advance per instance.
+        void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout,
+                       unsigned int firstIndex = 0, unsigned int divisor = 0);
 
         void Bind() const;
         void Unbind() const;
@@ -1,23 +1,49 @@
 #include <VertexBuffer.h>
+#include <Profiler.h>
+#include <RenderStats.h>
 
 VertexBuffer::VertexBuffer(const void* data, unsigned int size)
+    : m_Size(size)
 {
     GLCall(glGenBuffers(1, &m_RendererID));
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+    Bind();
     GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+    RenderStats::CountBufferUpload(size);
+}
+
+VertexBuffer::VertexBuffer(unsigned int size)
+    : m_Size(size)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    Bind();
+    GLCall(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW));
+}
+
+void VertexBuffer::SetData(const void* data, unsigned int size)
+{
+    PROFILE_SCOPE("VertexBuffer::SetData");
+    Bind();
+    if (size > m_Size)
+        m_Size = size;
+    GLCall(glBufferData(GL_ARRAY_BUFFER, m_Size, nullptr, GL_STREAM_DRAW));
+    GLCall(glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
+    RenderStats::CountBufferUpload(size);
 }
 
 VertexBuffer::~VertexBuffer()
 {
+    RenderStats::CountDelete(BindTarget::ArrayBuffer, m_RendererID);
     GLCall(glDeleteBuffers(1, &m_RendererID));
 }
 
 void VertexBuffer::Bind() const
 {
+    RenderStats::CountBind(BindTarget::ArrayBuffer, m_RendererID);
     GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
 }
 
 void VertexBuffer::Unbind() const
 {
+    RenderStats::CountBind(BindTarget::ArrayBuffer, 0);
     GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
 }
\ No newline at end of file
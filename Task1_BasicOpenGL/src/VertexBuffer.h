@@ -7,10 +7,19 @@ class VertexBuffer
 {
     private:
         unsigned int m_RendererID;
+        unsigned int m_Size;
     public:
         VertexBuffer(const void* data, unsigned int size);
+        // Empty buffer that is refilled with SetData (e.g. per-instance data)
+        VertexBuffer(unsigned int size);
         ~VertexBuffer();
 
+        VertexBuffer(const VertexBuffer&) = delete;
+        VertexBuffer& operator=(const VertexBuffer&) = delete;
+
+        // Replaces the contents, the storage is orphaned so the GPU never waits on it
+        void SetData(const void* data, unsigned int size);
+
         void Bind() const;
         void Unbind() const;
 };
\ No newline at end of file
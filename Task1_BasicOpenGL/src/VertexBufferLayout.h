@@ -6,11 +6,18 @@
 
 #include <vector>
 
+// Raw IEEE 754 half-precision value, for GL_HALF_FLOAT attributes
+struct HalfFloat
+{
+    unsigned short bits;
+};
+
 struct VertexBufferElement
 {
     unsigned int type;
     unsigned int count;
     unsigned char normalized;
+    bool integer; // read as int/uint in the shader (glVertexAttribIPointer)
 
     static unsigned int GetSizeOfType(unsigned int type)
     {
@@ -20,6 +27,14 @@ struct VertexBufferElement
             return 4;
         case GL_UNSIGNED_INT:
             return 4;
+        case GL_HALF_FLOAT:
+            return 2;
+        case GL_SHORT:
+            return 2;
+        case GL_UNSIGNED_SHORT:
+            return 2;
+        case GL_BYTE:
+            return 1;
         case GL_UNSIGNED_BYTE:
             return 1;
         }
@@ -44,6 +59,13 @@ class VertexBufferLayout
             static_assert(sizeof(T) == 0, "Unsupported type!");
         }
 
+        // Integer attribute, not converted to float
+        template<typename T>
+        void PushInteger(unsigned int count)
+        {
+            static_assert(sizeof(T) == 0, "Unsupported type!");
+        }
+
         inline const std::vector<VertexBufferElement> GetElements() const { return m_Elements; }
         inline unsigned int GetStride() const { return m_Stride; }
 };
@@ -51,20 +73,65 @@ class VertexBufferLayout
 template<>
 inline void VertexBufferLayout::Push<float>(unsigned int count)
 {
-    m_Elements.push_back({ GL_FLOAT, count, GL_FALSE });
+    m_Elements.push_back({ GL_FLOAT, count, GL_FALSE, false });
     m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
 }
 
+template<>
+inline void VertexBufferLayout::Push<HalfFloat>(unsigned int count)
+{
+    m_Elements.push_back({ GL_HALF_FLOAT, count, GL_FALSE, false });
+    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_HALF_FLOAT);
+}
+
 template<>
 inline void VertexBufferLayout::Push<unsigned int>(unsigned int count)
 {
-    m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE });
+    m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE, false });
     m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
 }
 
+// Normalized to [-1, 1]
+template<>
+inline void VertexBufferLayout::Push<short>(unsigned int count)
+{
+    m_Elements.push_back({ GL_SHORT, count, GL_TRUE, false });
+    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_SHORT);
+}
+
+// Normalized to [0, 1]
+template<>
+inline void VertexBufferLayout::Push<unsigned short>(unsigned int count)
+{
+    m_Elements.push_back({ GL_UNSIGNED_SHORT, count, GL_TRUE, false });
+    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_SHORT);
+}
+
+// Normalized to [-1, 1]
+template<>
+inline void VertexBufferLayout::Push<signed char>(unsigned int count)
+{
+    m_Elements.push_back({ GL_BYTE, count, GL_TRUE, false });
+    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_BYTE);
+}
+
 template<>
 inline void VertexBufferLayout::Push<unsigned char>(unsigned int count)
 {
-    m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE });
+    m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE, false });
+    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+}
+
+template<>
+inline void VertexBufferLayout::PushInteger<unsigned int>(unsigned int count)
+{
+    m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE, true });
+    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
+}
+
+template<>
+inline void VertexBufferLayout::PushInteger<unsigned char>(unsigned int count)
+{
+    m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_FALSE, true });
     m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
-}
\ No newline at end of file
+}
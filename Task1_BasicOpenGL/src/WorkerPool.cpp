@@ -0,0 +1,84 @@
+#include "WorkerPool.h"
+#include "Profiler.h"
+
+WorkerPool::WorkerPool(unsigned int threadCount, size_t maxQueued)
+    : m_MaxQueued(maxQueued), m_Running(0), m_Stopping(false)
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned int i = 0; i < threadCount; i++)
+        m_Threads.emplace_back(&WorkerPool::WorkerLoop, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_JobAvailable.notify_all();
+
+    // Queued jobs are still run before the threads exit
+    for (auto& thread : m_Threads)
+        thread.join();
+}
+
+void WorkerPool::Submit(std::function<void()> job)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        if (m_MaxQueued > 0)
+            m_JobFinished.wait(lock, [this] { return m_Jobs.size() < m_MaxQueued; });
+        m_Jobs.push_back(std::move(job));
+    }
+    m_JobAvailable.notify_one();
+}
+
+bool WorkerPool::TrySubmit(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_MaxQueued > 0 && m_Jobs.size() >= m_MaxQueued)
+            return false;
+        m_Jobs.push_back(std::move(job));
+    }
+    m_JobAvailable.notify_one();
+    return true;
+}
+
+void WorkerPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_JobFinished.wait(lock, [this] { return m_Jobs.empty() && m_Running == 0; });
+}
+
+void WorkerPool::WorkerLoop()
+{
+    PROFILE_THREAD("worker");
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_JobAvailable.wait(lock, [this] { return m_Stopping || !m_Jobs.empty(); });
+            if (m_Jobs.empty())
+                return;
+
+            job = std::move(m_Jobs.front());
+            m_Jobs.pop_front();
+            m_Running++;
+        }
+
+        {
+            PROFILE_SCOPE("WorkerPool job");
+            job();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Running--;
+        }
+        m_JobFinished.notify_all();
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads consuming a FIFO of jobs
+class WorkerPool
+{
+    private:
+        std::vector<std::thread> m_Threads;
+        std::deque<std::function<void()>> m_Jobs;
+        std::mutex m_Mutex;
+        std::condition_variable m_JobAvailable;
+        std::condition_variable m_JobFinished;
+        size_t m_MaxQueued;
+        int m_Running;
+        bool m_Stopping;
+    public:
+        // threadCount 0 = one per hardware thread. maxQueued 0 = unbounded.
+        WorkerPool(unsigned int threadCount = 0, size_t maxQueued = 0);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        // Blocks while the queue is full (back-pressure)
+        void Submit(std::function<void()> job);
+        // Returns false instead of blocking when the queue is full
+        bool TrySubmit(std::function<void()> job);
+        // Blocks until every submitted job has finished
+        void Wait();
+
+        inline unsigned int GetThreadCount() const { return (unsigned int)m_Threads.size(); }
+    private:
+        void WorkerLoop();
+};
@@ -6,28 +6,55 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "Camera.h"
+#include "Benchmark.h"
+#include "CommandLine.h"
+#include "CubeFile.h"
+#include "Clock.h"
+#include "CubeRenderer.h"
+#include "FrameCapture.h"
+#include "GLExtensions.h"
+#include "GpuTimer.h"
+#include "Headless.h"
+#include "InputLog.h"
+#include "MoveQueue.h"
+#include "PerfOverlay.h"
+#include "PickingBuffer.h"
+#include "Profiler.h"
+#include "RenderStats.h"
 #include "RubiksCube.h" 
+#include "Simulation.h"
 
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <chrono>
+#include <thread>
 #include <algorithm> // For std::min, std::max
 
-// Window settings
-const unsigned int SCR_WIDTH = 800;
-const unsigned int SCR_HEIGHT = 800;
+// Longest sleep of an idle window, in case a change comes without an event
+const double IDLE_TIMEOUT = 0.5;
+
+// Replays run one frame per step of this clock
+const double REPLAY_FRAME_TIME = 1.0 / 60.0;
 
 // Application State
 struct AppState {
     Camera* camera = nullptr;
+    bool needsRedraw = true; // set by anything that changes the picture
     
     // Mouse State
     bool firstMouse = true;
-    double lastX = SCR_WIDTH / 2.0;
-    double lastY = SCR_HEIGHT / 2.0;
+    double lastX = 0.0; // set by the first cursor event
+    double lastY = 0.0;
     bool leftMousePressed = false;
     bool rightMousePressed = false;
 
-    // Cube Logic
-    RubiksCube* cube = nullptr;
+    // Cube Logic: the cube, its turns and the hover highlight live on the
+    // simulation thread, input reaches them through Simulation::Post
+    Simulation* simulation = nullptr;
+    CubeRenderer* renderer = nullptr;
+    int cubeSize = 3;
     glm::mat4 globalCubeRotation = glm::mat4(1.0f);
 
     // Bonus: Selection Logic (Center of Rotation)
@@ -36,52 +63,239 @@ struct AppState {
     int selectedLayerY = 1;
     int selectedLayerZ = 1;
 
-    // Turn Logic
-    bool isTurning = false;
-    glm::vec3 turnAxis = glm::vec3(0);
-    float turnTargetDeg = 90.0f;
-    float turnCurrentDeg = 0.0f;
-    float turnSpeed = 180.0f; // degrees per second
+    // Turn Logic: keys and --play queue turns in the simulation's MoveQueue
     int turnDir = 1; // 1 or -1
     float stepDeg = 90.0f;
-    
-    // Which index is currently active
-    int currentActiveLayerIndex = -1; 
 
     bool isPickingMode = false;
     int pickedCubieId = -1;
+    int pickedFace = -1;
     float pickedDepth = 0.0f;
+    PickingBuffer* picking = nullptr;
+    GpuTimer* pickingTimer = nullptr;
+
+    // Performance overlay (F3 key)
+    bool showOverlay = false;
+
+    // Sticker texture (T key), preloaded in the background at startup
+    TextureHandle stickerTexture;
+
+    // Picture cube (X key), loaded from --picture
+    std::shared_ptr<TextureArray> picture;
+
+    // Recording (C key)
+    const AppOptions* options = nullptr;
+    FrameCapture* capture = nullptr;
+
+    // Input log (--record / --replay). While replaying, live input is ignored
+    // and the handlers only see the logged events.
+    const Clock* clock = nullptr;
+    InputRecorder* recorder = nullptr;
+    InputReplay* replay = nullptr;
 };
 
-// Input Callbacks declarations
+// Input Callbacks declarations: the GLFW callbacks log live input and pass it
+// on to the handlers, which a replay calls directly
 void FramebufferSizeCallback(GLFWwindow* window, int width, int height);
 void MouseCallback(GLFWwindow* window, double xpos, double ypos);
 void ScrollCallback(GLFWwindow* window, double xoffset, double yoffset);
 void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
 void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
-glm::vec3 GetWorldPos(double mouseX, double mouseY, float depth, Camera* cam) 
+void RefreshCallback(GLFWwindow* window);
+
+void HandleFramebufferSize(GLFWwindow* window, int width, int height);
+void HandleCursorPos(GLFWwindow* window, double xpos, double ypos);
+void HandleScroll(GLFWwindow* window, double xoffset, double yoffset);
+void HandleMouseButton(GLFWwindow* window, int button, int action, int mods);
+void HandleKey(GLFWwindow* window, int key, int action, int mods);
+void DispatchInput(GLFWwindow* window, const InputEvent& event);
+
+// Cursor position (window coordinates) to framebuffer pixels, origin top-left
+glm::vec2 CursorToFramebuffer(GLFWwindow* window, double xpos, double ypos)
 {
-    GLint viewport[4];
-    glGetIntegerv(GL_VIEWPORT, viewport);
+    int width, height, winWidth, winHeight;
+    glfwGetFramebufferSize(window, &width, &height);
+    glfwGetWindowSize(window, &winWidth, &winHeight);
+    if (winWidth <= 0 || winHeight <= 0)
+        return glm::vec2(0.0f);
 
-    // OpenGL Y is inverted (0 at bottom), Mouse Y is 0 at top
-    glm::vec3 winCoord = glm::vec3(mouseX, viewport[3] - mouseY, depth);
-    
-    glm::mat4 view = cam->GetViewMatrix();
-    glm::mat4 projection = cam->GetProjectionMatrix();
+    return glm::vec2((float)xpos * width / winWidth, (float)ypos * height / winHeight);
+}
+
+// Hover highlight, cheap enough to run on every mouse move
+void UpdateHover(AppState* s, const glm::vec2& cursor)
+{
+    glm::vec3 origin, direction;
+    s->camera->GetRay(cursor.x, cursor.y, origin, direction);
+
+    glm::mat4 rotation = s->globalCubeRotation;
+    s->simulation->Post([origin, direction, rotation](SimulationState& state)
+    {
+        RayHit hit;
+        bool found = state.cube->RayCast(origin, direction, rotation, hit, state.moves.GetTurns());
+        state.highlightedId = found ? hit.cubieId : -1;
+    });
+}
+
+// Starts or stops recording the window at its current framebuffer size
+void ToggleCapture(AppState* s, GLFWwindow* window)
+{
+    if (s->capture)
+    {
+        s->capture->Finish();
+        std::cout << "Capture stopped: " << s->capture->GetFrameCount()
+                  << " frames written, " << s->capture->GetDroppedCount() << " dropped" << std::endl;
+        delete s->capture;
+        s->capture = nullptr;
+        return;
+    }
+
+    int width, height;
+    glfwGetFramebufferSize(window, &width, &height);
+
+    const AppOptions& options = *s->options;
+    std::string path = options.captureOutput.empty() ? FrameCapture::GetDefaultPath(options.captureFormat) : options.captureOutput;
+    s->capture = new FrameCapture(width, height, options.captureFormat, path);
+    if (!s->capture->IsValid())
+    {
+        delete s->capture;
+        s->capture = nullptr;
+        return;
+    }
+    std::cout << "Capture started: " << width << "x" << height << " -> " << path << std::endl;
+}
 
-    return glm::unProject(winCoord, view, projection, glm::vec4(viewport[0], viewport[1], viewport[2], viewport[3]));
+// One layer per face in Face order, see RubiksCube::SetPicture
+std::shared_ptr<TextureArray> LoadPicture(const std::string& path)
+{
+    std::vector<std::string> faces(6, path);
+    if (std::filesystem::is_directory(path))
+    {
+        const char* names[6] = { "U.png", "D.png", "B.png", "F.png", "R.png", "L.png" };
+        for (int f = 0; f < 6; f++)
+            faces[f] = (std::filesystem::path(path) / names[f]).string();
+    }
+    return std::make_shared<TextureArray>(faces, 512, 512);
 }
 
-int main()
+// Queues a --play file: move notation, or a binary move stream (which also
+// sets the cube to the state the stream starts from)
+void QueuePlayback(const std::string& path, RubiksCube& cube, MoveQueue& moves)
 {
+    if (IsCubeFile(path))
+    {
+        CubeFileReader reader(path);
+        CubeState start;
+        MoveCursor cursor;
+        if (!reader.IsValid() || reader.GetKind() != CubeFileKind::Moves || !reader.Seek(0, start, cursor))
+        {
+            std::cout << "Playback: " << path << " is not a move stream " << reader.GetError() << std::endl;
+            return;
+        }
+        if (!cube.SetState(start))
+        {
+            std::cout << "Playback: " << path << " is for a cube of size " << reader.GetCubeSize() << std::endl;
+            return;
+        }
+
+        Move move;
+        while (cursor.Next(move))
+            moves.Push(move);
+    }
+    else
+    {
+        std::ifstream file(path);
+        std::stringstream text;
+        text << file.rdbuf();
+
+        std::vector<Move> parsed;
+        std::string error;
+        if (!file || !ParseMoves(text.str(), cube.GetSize(), parsed, &error))
+        {
+            std::cout << "Playback: cannot read " << path << " " << error << std::endl;
+            return;
+        }
+        for (const Move& move : parsed)
+            moves.Push(move);
+    }
+    std::cout << "Playback: " << moves.GetQueuedCount() << " moves queued" << std::endl;
+}
+
+// FNV-1a of the packed cube state, printed at the end of a replay to compare runs
+uint64_t HashCubeState(const RubiksCube& cube)
+{
+    CubeState state;
+    cube.GetState(state);
+    std::vector<unsigned char> packed(GetPackedStateSize(state.size));
+    PackState(state, packed.data());
+
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char byte : packed)
+        hash = (hash ^ byte) * 1099511628211ull;
+    return hash;
+}
+
+// --trace / F9: the last traceSeconds of every thread as a Chrome trace
+void DumpTrace(const AppOptions& options)
+{
+#ifdef ENABLE_PROFILER
+    std::string path = options.tracePath.empty() ? "trace.json" : options.tracePath;
+    int count = Profiler::WriteTrace(path, options.traceSeconds);
+    if (count < 0)
+        std::cout << "Trace: cannot write " << path << std::endl;
+    else
+        std::cout << "Trace: " << count << " events -> " << path << std::endl;
+#else
+    std::cout << "Trace: built without the profiler (make PROFILER=1)" << std::endl;
+#endif
+}
+
+// Decodes a finished picking readback (requested on click, collected a frame later)
+void ApplyPickingResult(AppState* s, const PickingResult& result)
+{
+    s->pickedDepth = result.depth;
+
+    if (result.id == 0) 
+    {
+        s->pickedCubieId = -1;
+        s->pickedFace = -1;
+        std::cout << "Picked: None" << std::endl;
+    }
+    else 
+    {
+        s->pickedCubieId = (int)result.id - 1;
+        s->pickedFace = (int)result.face;
+        std::cout << "Picked Cubie ID: " << s->pickedCubieId << " (face " << s->pickedFace << ")" << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    AppOptions options;
+    if (!ParseCommandLine(argc, argv, options) || options.showHelp)
+    {
+        PrintUsage(argv[0]);
+        return options.showHelp ? 0 : 1;
+    }
+    PROFILE_THREAD("main");
+
+    // Batch rendering and benchmarks, no window or GLFW involved
+    if (!options.headlessInput.empty() || !options.benchmarkOutput.empty())
+    {
+        int result = options.headlessInput.empty() ? RunBenchmark(options) : RunHeadless(options);
+        if (!options.tracePath.empty())
+            DumpTrace(options);
+        return result;
+    }
+
     // Initialize GLFW
     if (!glfwInit()) return -1;
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, options.glDebug != GLDebugLevel::Off ? GLFW_TRUE : GLFW_FALSE);
 
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Rubik's Cube Assignment", NULL, NULL);
+    GLFWwindow* window = glfwCreateWindow(options.width, options.height, "Rubik's Cube Assignment", NULL, NULL);
     if (!window) {
         glfwTerminate();
         return -1;
@@ -92,6 +306,8 @@ int main()
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         return -1;
     }
+    LoadGLExtensions((GLADloadproc)glfwGetProcAddress);
+    EnableGLDebugOutput(options.glDebug);
 
     // --- SCOPE START: Objects must be destroyed before glfwTerminate ---
     {
@@ -99,14 +315,74 @@ int main()
 
         // Initialize State
         AppState state;
-        Camera camera(SCR_WIDTH, SCR_HEIGHT, glm::vec3(0.0f, 0.0f, 15.0f));
-        
-        // Change cube size here (Bonus)
-        int cubeSize = 3; 
+
+        // Cube size comes from --size (Bonus), the camera backs off for big cubes
+        int cubeSize = options.cubeSize;
+        Camera camera = Camera::FrameCube(options.width, options.height, cubeSize);
+        TextureCache textures;
         RubiksCube rubiksCube(cubeSize);
+        CubeRenderer renderer(cubeSize);
         
+        int fbWidth, fbHeight;
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+        PickingBuffer picking(fbWidth, fbHeight);
+
+        // GPU time per pass, read a few frames late, and the overlay showing it
+        GpuTimer mainPassTimer;
+        GpuTimer pickingTimer;
+        GpuTimer captureTimer;
+        PerfOverlay overlay;
+        PerfStats stats;
+
         state.camera = &camera;
-        state.cube = &rubiksCube;
+        state.renderer = &renderer;
+        state.cubeSize = cubeSize;
+        state.picking = &picking;
+        state.pickingTimer = &pickingTimer;
+        state.showOverlay = options.overlay;
+        state.options = &options;
+        state.stickerTexture = textures.Load("res/textures/plane.png");
+        if (!options.picture.empty())
+        {
+            state.picture = LoadPicture(options.picture);
+            renderer.SetPicture(state.picture);
+        }
+
+        // Input log: a replay drives the app from a FixedClock, everything
+        // else (recording included) runs on real time
+        SystemClock systemClock;
+        FixedClock replayClock(REPLAY_FRAME_TIME);
+        std::unique_ptr<InputReplay> replay;
+        std::unique_ptr<InputRecorder> recorder;
+        state.clock = &systemClock;
+        if (!options.replayInput.empty())
+        {
+            replay = std::make_unique<InputReplay>(options.replayInput);
+            if (replay->IsValid())
+            {
+                state.replay = replay.get();
+                state.clock = &replayClock;
+                std::cout << "Replay: " << replay->GetCount() << " events, " << replay->GetDuration() << " s" << std::endl;
+            }
+            else
+                std::cout << "Replay: " << options.replayInput << ": " << replay->GetError() << std::endl;
+        }
+        else if (!options.recordInput.empty())
+        {
+            recorder = std::make_unique<InputRecorder>(options.recordInput);
+            if (recorder->IsValid())
+                state.recorder = recorder.get();
+        }
+
+        // Stopped before the cube goes away. A replay steps it from its own
+        // clock instead of the thread, so each run sees the same steps.
+        Simulation simulation(rubiksCube);
+        state.simulation = &simulation;
+        simulation.SetPublishCallback([]() { glfwPostEmptyEvent(); });
+        if (!options.playInput.empty())
+            QueuePlayback(options.playInput, rubiksCube, simulation.GetState().moves);
+        if (!state.replay)
+            simulation.Start();
         
         // Initialize selection to center
         state.selectedLayerX = cubeSize / 2;
@@ -115,16 +391,30 @@ int main()
 
         glfwSetWindowUserPointer(window, &state);
 
+        // The recording starts with the window size, a replay sets it up the same way
+        if (state.recorder)
+            FramebufferSizeCallback(window, fbWidth, fbHeight);
+
+        // A replay starts with every texture in place and, at speed 0, does
+        // not wait for V-Sync
+        if (state.replay)
+        {
+            while (textures.GetPendingCount() > 0)
+            {
+                textures.Update();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            if (options.replaySpeed <= 0.0)
+                glfwSwapInterval(0);
+        }
+
         // Callbacks
         glfwSetFramebufferSizeCallback(window, FramebufferSizeCallback);
         glfwSetCursorPosCallback(window, MouseCallback);
         glfwSetScrollCallback(window, ScrollCallback);
         glfwSetMouseButtonCallback(window, MouseButtonCallback);
         glfwSetKeyCallback(window, KeyCallback);
-
-        // Timing
-        float deltaTime = 0.0f;
-        float lastFrame = 0.0f;
+        glfwSetWindowRefreshCallback(window, RefreshCallback);
 
         std::cout << "Controls:\n";
         std::cout << "Arrows Left/Right: Change X Layer Selection\n";
@@ -132,46 +422,149 @@ int main()
         std::cout << "I / O: Change Z Layer Selection\n";
         std::cout << "R/L/U/D/F/B: Rotate the SELECTED layer on that axis\n";
         std::cout << "Space: Reverse direction\n";
-
+        std::cout << "T: Toggle textured stickers\n";
+        std::cout << "C: Start/stop recording\n";
+        std::cout << "F3: Toggle performance overlay\n";
+        std::cout << "F4: Print the render statistics of the last frame\n";
+        std::cout << "F9: Save a trace of the last seconds\n";
+        if (state.picture)
+            std::cout << "X: Toggle picture cube\n";
+
+        int frameCount = 0;
+        int drawnCount = 0;
         while (!glfwWindowShouldClose(window))
         {
-            float currentFrame = (float)glfwGetTime();
-            deltaTime = currentFrame - lastFrame;
-            lastFrame = currentFrame;
+            PROFILE_SCOPE("Frame");
+            auto frameStart = std::chrono::steady_clock::now();
+            frameCount++;
 
-            // Render
-            glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            // Replay: one fixed step per frame, with the events and simulation
+            // steps due by then. Stops once the log and the turns are done.
+            if (state.replay)
+            {
+                replayClock.Advance();
+                InputEvent event;
+                while (state.replay->Next(replayClock.GetTime(), event))
+                    DispatchInput(window, event);
+                simulation.Advance(replayClock.GetTime());
+
+                if (state.replay->IsFinished() && !simulation.GetState().moves.IsTurning())
+                    glfwSetWindowShouldClose(window, GLFW_TRUE);
+            }
 
-            // Update Animation
-            if (state.isTurning)
+            // Textures whose decode finished since the last frame
+            int pendingTextures = textures.GetPendingCount();
+            textures.Update();
+            if (textures.GetPendingCount() != pendingTextures)
+                state.needsRedraw = true;
+
+            // Picking requested by a click in an earlier frame. A replay waits
+            // for it, so it lands in the same frame every run.
+            PickingResult pickingResult;
+            if (state.picking->TryGetResult(pickingResult, state.replay != nullptr))
+                ApplyPickingResult(&state, pickingResult);
+
+            // Turns and highlight changes from the simulation
+            if (simulation.UpdateSnapshot())
+                state.needsRedraw = true;
+
+            // GPU times of earlier frames, whichever have landed
+            mainPassTimer.Update();
+            pickingTimer.Update();
+            captureTimer.Update();
+            stats.gpuMs = mainPassTimer.GetMilliseconds();
+            stats.pickingMs = pickingTimer.GetMilliseconds();
+            stats.captureMs = captureTimer.GetMilliseconds();
+
+            bool draw = state.needsRedraw || state.capture || options.continuous;
+            if (draw)
             {
-                float step = state.turnSpeed * deltaTime;
-                state.turnCurrentDeg += step;
-                if (state.turnCurrentDeg >= std::abs(state.turnTargetDeg))
+                PROFILE_SCOPE("Render");
+                state.needsRedraw = false;
+                drawnCount++;
+
+                // Render
+                glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+                // Matrices (cached by the camera, only rebuilt after it moves)
+                const glm::mat4& viewProj = state.camera->GetViewProjectionMatrix();
+                glm::mat4 model = state.globalCubeRotation; 
+
+                // Whatever the simulation published last, turns and highlight included
+                const std::vector<CubieDrawData>& draws = simulation.GetSnapshot().draws;
+                mainPassTimer.Begin();
+                renderer.Draw(viewProj, model, draws);
+                mainPassTimer.End();
+
+                // Readback is queued here and collected a few frames later
+                if (state.capture)
+                {
+                    captureTimer.Begin();
+                    state.capture->CaptureFrame();
+                    captureTimer.End();
+                }
+
+                // After the capture, recordings show the cube only. The frame's
+                // statistics end here too, the overlay isn't counted.
+                RenderStats::EndFrame();
+                stats.render = RenderStats::GetLastFrame();
+                stats.cubies = (unsigned int)draws.size();
+                stats.cubiesDrawn = (unsigned int)std::count_if(draws.begin(), draws.end(),
+                                                                [](const CubieDrawData& draw) { return !draw.hidden; });
+                stats.cpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+                overlay.AddFrame(stats);
+                if (state.showOverlay)
                 {
-                    state.turnCurrentDeg = std::abs(state.turnTargetDeg);
-                    state.isTurning = false;
-                    // Pass the active index to FinishTurn
-                    state.cube->FinishTurn(state.turnAxis, state.turnTargetDeg, state.currentActiveLayerIndex);
+                    int width, height;
+                    glfwGetFramebufferSize(window, &width, &height);
+                    overlay.Draw(stats, width, height);
                 }
+
+                PROFILE_SCOPE("SwapBuffers");
+                glfwSwapBuffers(window);
             }
 
-            // Matrices
-            glm::mat4 view = state.camera->GetViewMatrix();
-            glm::mat4 projection = state.camera->GetProjectionMatrix();
-            glm::mat4 viewProj = projection * view;
-            glm::mat4 model = state.globalCubeRotation; 
+            if (state.replay)
+            {
+                // Window events only, live input is dropped. Paced to the
+                // replay clock unless running as fast as possible.
+                glfwPollEvents();
+                if (options.replaySpeed > 0.0)
+                {
+                    double wait = replayClock.GetTime() / options.replaySpeed - systemClock.GetTime();
+                    if (wait > 0.0)
+                        std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+                }
+            }
+            else if (draw)
+                glfwPollEvents();
+            else
+            {
+                // Idle: sleep until input, a window event or a new snapshot (which
+                // posts an empty event). Readbacks in flight are polled instead.
+                PROFILE_SCOPE("WaitEvents");
+                bool busy = state.picking->IsPending() || textures.GetPendingCount() > 0;
+                glfwWaitEventsTimeout(busy ? 0.001 : IDLE_TIMEOUT);
+            }
+        }
 
-            // Animation Params
-            bool isAnim = state.isTurning;
-            float currentAnimAngle = (state.turnTargetDeg < 0) ? -state.turnCurrentDeg : state.turnCurrentDeg;
+        if (!options.tracePath.empty())
+            DumpTrace(options);
 
-            // Pass the active index to Draw
-            state.cube->Draw(viewProj, model, isAnim, state.turnAxis, currentAnimAngle, state.currentActiveLayerIndex);
+        if (state.capture)
+            ToggleCapture(&state, window);
 
-            glfwSwapBuffers(window);
-            glfwPollEvents();
+        if (state.recorder)
+        {
+            state.recorder->Close();
+            std::cout << "Recorded " << state.recorder->GetCount() << " events to " << options.recordInput << std::endl;
+        }
+        if (state.replay)
+        {
+            std::cout << "Replay: " << frameCount << " frames (" << drawnCount << " drawn) in "
+                      << systemClock.GetTime() << " s, state " << std::hex << HashCubeState(rubiksCube)
+                      << std::dec << std::endl;
         }
 
     } // --- SCOPE END: Destructors run here while OpenGL context is still valid ---
@@ -181,15 +574,96 @@ int main()
 }
 
 // Callbacks implementation...
-// (Make sure to include the callback function implementations below or in a separate file as before)
+// Live input: logged when recording, dropped while a replay drives the app
+void OnLiveInput(GLFWwindow* window, InputEvent event)
+{
+    AppState* s = (AppState*)glfwGetWindowUserPointer(window);
+    if (!s || s->replay) return;
+
+    if (s->recorder)
+    {
+        // Handled as stored, so the replay sees exactly the same values
+        event.time = s->clock->GetTime();
+        event.x = (float)event.x;
+        event.y = (float)event.y;
+        s->recorder->Record(event);
+    }
+    DispatchInput(window, event);
+}
+
 void FramebufferSizeCallback(GLFWwindow* window, int width, int height)
+{
+    InputEvent event;
+    event.type = InputEventType::FramebufferSize;
+    event.x = width;
+    event.y = height;
+    OnLiveInput(window, event);
+}
+
+void MouseCallback(GLFWwindow* window, double xpos, double ypos)
+{
+    InputEvent event;
+    event.type = InputEventType::CursorPos;
+    event.x = xpos;
+    event.y = ypos;
+    OnLiveInput(window, event);
+}
+
+void ScrollCallback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    InputEvent event;
+    event.type = InputEventType::Scroll;
+    event.x = xoffset;
+    event.y = yoffset;
+    OnLiveInput(window, event);
+}
+
+void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
+{
+    InputEvent event;
+    event.type = InputEventType::MouseButton;
+    event.code = button;
+    event.action = action;
+    event.mods = mods;
+    OnLiveInput(window, event);
+}
+
+void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    InputEvent event;
+    event.type = InputEventType::Key;
+    event.code = key;
+    event.action = action;
+    event.mods = mods;
+    OnLiveInput(window, event);
+}
+
+void DispatchInput(GLFWwindow* window, const InputEvent& event)
+{
+    switch (event.type)
+    {
+        case InputEventType::Key:             HandleKey(window, event.code, event.action, event.mods); break;
+        case InputEventType::CursorPos:       HandleCursorPos(window, event.x, event.y); break;
+        case InputEventType::MouseButton:     HandleMouseButton(window, event.code, event.action, event.mods); break;
+        case InputEventType::Scroll:          HandleScroll(window, event.x, event.y); break;
+        case InputEventType::FramebufferSize: HandleFramebufferSize(window, (int)event.x, (int)event.y); break;
+    }
+}
+
+void HandleFramebufferSize(GLFWwindow* window, int width, int height)
 {
     glViewport(0, 0, width, height);
     AppState* s = (AppState*)glfwGetWindowUserPointer(window);
+    if (s) s->needsRedraw = true;
     if (s && s->camera) s->camera->UpdateSize(width, height);
+    if (s && s->picking) s->picking->Resize(width, height);
+
+    // Recordings have a fixed frame size
+    if (s && s->capture)
+        ToggleCapture(s, window);
 }
 
-void MouseCallback(GLFWwindow* window, double xpos, double ypos)
+void HandleCursorPos(GLFWwindow* window, double xpos, double ypos)
 {
     AppState* s = (AppState*)glfwGetWindowUserPointer(window);
     if (!s) return;
@@ -207,18 +681,28 @@ void MouseCallback(GLFWwindow* window, double xpos, double ypos)
     s->lastX = xpos;
     s->lastY = ypos;
 
+    glm::vec2 cursor = CursorToFramebuffer(window, xpos, ypos);
+
+    if (s->isPickingMode && !s->leftMousePressed && !s->rightMousePressed)
+        UpdateHover(s, cursor);
+
+    // Dragging moves the camera or the cube, plain hovering changes nothing here
+    if (s->leftMousePressed || s->rightMousePressed)
+        s->needsRedraw = true;
+
     if (s->rightMousePressed)
     {
         if (s->isPickingMode && s->pickedCubieId != -1)
         {
-            glm::vec3 globalMousePos = GetWorldPos(xpos, ypos, s->pickedDepth, s->camera);
+            glm::vec3 globalMousePos = s->camera->Unproject(cursor.x, cursor.y, s->pickedDepth);
 
             glm::mat4 inverseModel = glm::inverse(s->globalCubeRotation);
             
             glm::vec4 localMousePos4 = inverseModel * glm::vec4(globalMousePos, 1.0f);
             glm::vec3 localMousePos = glm::vec3(localMousePos4);
 
-            s->cube->SetCubiePosition(s->pickedCubieId, localMousePos);
+            int id = s->pickedCubieId;
+            s->simulation->Post([id, localMousePos](SimulationState& state) { state.cube->SetCubiePosition(id, localMousePos); });
         }
         else 
         {
@@ -234,7 +718,8 @@ void MouseCallback(GLFWwindow* window, double xpos, double ypos)
             glm::mat4 rotY = glm::rotate(glm::mat4(1.0f), xoffset * sensitivity, glm::vec3(0.0f, 1.0f, 0.0f));
             glm::mat4 rotX = glm::rotate(glm::mat4(1.0f), -yoffset * sensitivity, glm::vec3(1.0f, 0.0f, 0.0f));
             glm::mat4 deltaRot = rotX * rotY;
-            s->cube->UpdateCubieDesync(s->pickedCubieId, deltaRot);
+            int id = s->pickedCubieId;
+            s->simulation->Post([id, deltaRot](SimulationState& state) { state.cube->UpdateCubieDesync(id, deltaRot); });
         }
         else if (!s->isPickingMode)
         {
@@ -246,16 +731,17 @@ void MouseCallback(GLFWwindow* window, double xpos, double ypos)
     }
 }
 
-void ScrollCallback(GLFWwindow* window, double xoffset, double yoffset)
+void HandleScroll(GLFWwindow* window, double xoffset, double yoffset)
 {
     AppState* s = (AppState*)glfwGetWindowUserPointer(window);
     if (s && s->camera)
     {
         s->camera->Zoom((float)yoffset);
+        s->needsRedraw = true;
     }
 }
 
-void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
+void HandleMouseButton(GLFWwindow* window, int button, int action, int mods)
 {
     AppState* s = (AppState*)glfwGetWindowUserPointer(window);
     if (!s) return;
@@ -269,50 +755,27 @@ void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
             // --- COLOR PICKING LOGIC (Only on Click) ---
             if (s->isPickingMode)
             {
-                double xpos, ypos;
-                glfwGetCursorPos(window, &xpos, &ypos);
-
-                // 1. Clear Screen for Picking Draw
-                glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                PROFILE_SCOPE("Picking");
 
-                // 2. Draw Picking Scene
-                glm::mat4 view = s->camera->GetViewMatrix();
-                glm::mat4 projection = s->camera->GetProjectionMatrix();
-                glm::mat4 viewProj = projection * view;
-                
-                s->cube->DrawPicking(viewProj, s->globalCubeRotation);
-
-                // 3. Read Pixel
+                // 1. Locate the clicked pixel in framebuffer coordinates (the
+                // last cursor event, which is also what a replay has)
                 int width, height;
                 glfwGetFramebufferSize(window, &width, &height);
-                
-                int winWidth, winHeight;
-                glfwGetWindowSize(window, &winWidth, &winHeight);
-                float xScale = (float)width / (float)winWidth;
-                float yScale = (float)height / (float)winHeight;
-
-                int pixelX = (int)(xpos * xScale);
-                int pixelY = (int)((winHeight - ypos) * yScale); // Invert Y
-                float depth;
-                glReadPixels(pixelX, pixelY, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &depth);
-                s->pickedDepth = depth;
-
-                unsigned char data[4];
-                glReadPixels(pixelX, pixelY, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, data);
-
-                // 4. Decode ID
-                if (data[0] == 0 && data[1] == 0 && data[2] == 0) 
-                {
-                    s->pickedCubieId = -1;
-                    std::cout << "Picked: None" << std::endl;
-                }
-                else 
-                {
-                    int id = (int)data[0]; 
-                    s->pickedCubieId = id;
-                    std::cout << "Picked Cubie ID: " << id << std::endl;
-                }
+                glm::vec2 cursor = CursorToFramebuffer(window, s->lastX, s->lastY);
+
+                int pixelX = (int)cursor.x;
+                int pixelY = height - 1 - (int)cursor.y; // Invert Y
+
+                // 2. Draw Picking Scene offscreen, limited to that pixel
+                s->pickingTimer->Begin();
+                s->picking->Begin(pixelX, pixelY);
+                s->renderer->DrawPicking(s->camera->GetViewProjectionMatrix(), s->globalCubeRotation,
+                                         s->simulation->GetSnapshot().draws);
+                s->picking->End();
+                s->pickingTimer->End();
+
+                // 3. The ID is decoded in the main loop once the readback lands
+                s->pickedCubieId = -1;
             }
         }
         else if (action == GLFW_RELEASE) 
@@ -329,17 +792,18 @@ void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
     }
 }
 
-void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+void HandleKey(GLFWwindow* window, int key, int action, int mods)
 {
     AppState* s = (AppState*)glfwGetWindowUserPointer(window);
     if (!s || action != GLFW_PRESS) return;
+    s->needsRedraw = true;
 
     // 1. General Settings
     if (key == GLFW_KEY_SPACE) { s->turnDir *= -1; std::cout << "Direction flipped\n"; return; }
     if (key == GLFW_KEY_Z) { s->stepDeg = std::max(90.0f, s->stepDeg / 2.0f); return; }
     if (key == GLFW_KEY_A) { s->stepDeg = std::min(180.0f, s->stepDeg * 2.0f); return; }
 
-    int maxIndex = s->cube->GetSize() - 1;
+    int maxIndex = s->cubeSize - 1;
 
     // 2. Layer Selection Logic (Bonus)
     // X Axis Selection
@@ -380,13 +844,44 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
     if (key == GLFW_KEY_P) 
     { 
         s->isPickingMode = !s->isPickingMode; 
+        s->simulation->Post([](SimulationState& state) { state.highlightedId = -1; });
         std::cout << "Picking Mode: " << (s->isPickingMode ? "ON" : "OFF") << std::endl;
         return; 
     }
+    if (key == GLFW_KEY_X && s->picture)
+    {
+        s->renderer->SetPicture(s->renderer->HasPicture() ? nullptr : s->picture);
+        std::cout << "Picture Cube: " << (s->renderer->HasPicture() ? "ON" : "OFF") << std::endl;
+        return;
+    }
+    if (key == GLFW_KEY_C)
+    {
+        ToggleCapture(s, window);
+        return;
+    }
+    if (key == GLFW_KEY_F3)
+    {
+        s->showOverlay = !s->showOverlay;
+        return;
+    }
+    if (key == GLFW_KEY_F4)
+    {
+        std::cout << "Last frame: " << RenderStats::GetLastFrame().ToString() << std::endl;
+        return;
+    }
+    if (key == GLFW_KEY_F9)
+    {
+        DumpTrace(*s->options);
+        return;
+    }
+    if (key == GLFW_KEY_T)
+    {
+        s->renderer->SetStickerTexture(s->renderer->HasStickerTexture() ? nullptr : s->stickerTexture);
+        std::cout << "Textured Stickers: " << (s->renderer->HasStickerTexture() ? "ON" : "OFF") << std::endl;
+        return;
+    }
 
-    // 3. Perform Rotation
-    if (s->isTurning) return; 
-
+    // 3. Perform Rotation (queued behind any turn in progress)
     glm::vec3 axis(0.0f);
     bool validKey = true;
     int targetLayer = -1; 
@@ -428,10 +923,15 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
 
     if (validKey)
     {
-        s->isTurning = true;
-        s->turnAxis = axis;
-        s->turnTargetDeg = (float)s->turnDir * s->stepDeg;
-        s->turnCurrentDeg = 0.0f;
-        s->currentActiveLayerIndex = targetLayer;
+        QueuedTurn turn{ axis, (float)s->turnDir * s->stepDeg, targetLayer };
+        s->simulation->Post([turn](SimulationState& state) { state.moves.Push(turn); });
     }
-}
\ No newline at end of file
+}
+
+// Window exposed or damaged, the last frame has to be drawn again. Not during
+// a replay, whose frames depend on the log alone.
+void RefreshCallback(GLFWwindow* window)
+{
+    AppState* s = (AppState*)glfwGetWindowUserPointer(window);
+    if (s && !s->replay) s->needsRedraw = true;
+}
@@ -1,46 +1,115 @@
 #shader vertex
 #version 330
 
+// Variants (defined by Shader at load time):
+//   PICKING  - outputs (u_PickID, face) into an RG32UI target
+//   TEXTURED - modulates the sticker color with u_Texture
+//   PICTURE  - instanced, every sticker shows its part of a face image (u_Pictures)
+//   (none)   - flat sticker color
+
 layout(location = 0) in vec3 position;
-layout(location = 1) in vec3 color;
+layout(location = 1) in uint face; // Face enum value, see Cubie.h
+
+#ifdef PICKING
+flat out uint v_Face;
+#else
+flat out vec4 v_Color;
+#endif
+#if !defined(PICKING) && !defined(PICTURE)
+uniform vec4 u_FaceColors[6]; // sticker colors of the current cubie, by face
+#endif
+#ifdef TEXTURED
 layout(location = 2) in vec2 texCoord;
 
-out vec4 v_Color;
 out vec2 v_TexCoord;
+#endif
+#ifdef PICTURE
+layout(location = 2) in vec2 texCoord;
+
+// Per cubie, see RubiksCube::DrawPicture
+layout(location = 3) in mat4 i_Model;      // locations 3 - 6
+layout(location = 7) in uint i_Flags;      // 2 = highlighted
+layout(location = 8) in uvec4 i_FaceRectA; // corner of each sticker in its face image (unorm16 u, v),
+layout(location = 9) in uvec2 i_FaceRectB; // by Face, 0xFFFFFFFF = no sticker
+
+out vec3 v_TexCoord; // u, v, layer
 
-uniform mat4 u_MVP;
+uniform float u_StickerSize; // 1 / cube size
+#endif
 
+// Per-frame data, shared by every cubie (see RubiksCube::Draw)
+layout(std140) uniform FrameData
+{
+	mat4 u_ViewProj;
+	mat4 u_Global;
+};
+
+#ifdef PICTURE
 void main()
 {
-	gl_Position = u_MVP * vec4(position.x, position.y, position.z, 1.0);
-	v_Color = vec4(color.x, color.y, color.z, 1.0);
+	gl_Position = u_ViewProj * u_Global * i_Model * vec4(position, 1.0);
+
+	uint rect = (face < 4u) ? i_FaceRectA[face] : i_FaceRectB[face - 4u];
+	vec2 corner = vec2(float(rect & 0xFFFFu), float(rect >> 16)) / 65535.0;
+	v_TexCoord = vec3(corner + texCoord * u_StickerSize, float(face));
+
+	// Alpha 0 marks faces without a sticker
+	v_Color = (rect == 0xFFFFFFFFu) ? vec4(0.05, 0.05, 0.05, 0.0) : vec4(1.0);
+	if ((i_Flags & 2u) != 0u)
+		v_Color.rgb = v_Color.rgb * 0.6 + 0.4;
+}
+#else
+uniform mat4 u_Model; // layer turns included
+
+void main()
+{
+	gl_Position = u_ViewProj * u_Global * u_Model * vec4(position.x, position.y, position.z, 1.0);
+#ifdef PICKING
+	v_Face = face;
+#else
+	v_Color = u_FaceColors[face];
+#endif
+#ifdef TEXTURED
 	v_TexCoord = texCoord;
+#endif
 }
+#endif
 
 #shader fragment
 #version 330
 
+#ifdef PICKING
+layout(location = 0) out uvec2 PickID;
+
+flat in uint v_Face;
+
+uniform uint u_PickID; // cubie ID + 1, 0 is the background
+#else
 layout(location = 0) out vec4 FragColor;
 
-in vec4 v_Color;
+flat in vec4 v_Color;
+#endif
+#ifdef TEXTURED
 in vec2 v_TexCoord;
 
-uniform vec4 u_Color;
 uniform sampler2D u_Texture;
-uniform int u_PickingMode; // 0 = Normal, 1 = Picking
+#endif
+#ifdef PICTURE
+in vec3 v_TexCoord;
+
+uniform sampler2DArray u_Pictures; // one layer per face
+#endif
 
 void main()
 {
-    if (u_PickingMode == 1)
-    {
-        // In picking mode, ignore texture and vertex color.
-        // Output the unique color (ID) passed via u_Color.
-        FragColor = u_Color; 
-    }
-    else
-    {
-        // Normal Rendering
-        vec4 texColor = texture(u_Texture, v_TexCoord) * u_Color;
-        FragColor = texColor * v_Color;
-    }
-}
\ No newline at end of file
+#if defined(PICKING)
+	PickID = uvec2(u_PickID, v_Face);
+#elif defined(PICTURE)
+	vec4 picture = texture(u_Pictures, v_TexCoord);
+	FragColor = (v_Color.a == 0.0) ? vec4(v_Color.rgb, 1.0) : vec4(picture.rgb * v_Color.rgb, 1.0);
+#elif defined(TEXTURED)
+	FragColor = texture(u_Texture, v_TexCoord) * v_Color;
+#else
+	FragColor = v_Color;
+#endif
+}
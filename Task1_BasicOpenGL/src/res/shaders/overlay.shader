@@ -0,0 +1,28 @@
+#shader vertex
+#version 330
+
+// Flat colored quads in pixels, origin top-left (see PerfOverlay)
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec4 color;
+
+out vec4 v_Color;
+
+uniform vec2 u_ScreenSize;
+
+void main()
+{
+	gl_Position = vec4(position.x / u_ScreenSize.x * 2.0 - 1.0, 1.0 - position.y / u_ScreenSize.y * 2.0, 0.0, 1.0);
+	v_Color = color;
+}
+
+#shader fragment
+#version 330
+
+layout(location = 0) out vec4 FragColor;
+
+in vec4 v_Color;
+
+void main()
+{
+	FragColor = v_Color;
+}
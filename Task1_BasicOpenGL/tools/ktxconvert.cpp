@@ -0,0 +1,341 @@
+// Offline texture converter: PNG/JPG -> KTX2 with BC1 (opaque) or BC3 (alpha)
+// blocks and a full mip chain. Texture and TextureCache pick up the .ktx2
+// written next to the source image. Build and run with "make textures".
+//
+//   ktxconvert [--format auto|bc1|bc3] [--no-mips] <image> [<image> ...]
+
+#include <KtxImage.h>
+
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct Rgba { float r, g, b, a; };
+
+static float Distance(const Rgba& x, const Rgba& y)
+{
+    float dr = x.r - y.r, dg = x.g - y.g, db = x.b - y.b;
+    return dr * dr + dg * dg + db * db;
+}
+
+static unsigned short ToRgb565(const Rgba& c)
+{
+    int r = (int)std::lround(std::clamp(c.r, 0.0f, 255.0f) * 31.0f / 255.0f);
+    int g = (int)std::lround(std::clamp(c.g, 0.0f, 255.0f) * 63.0f / 255.0f);
+    int b = (int)std::lround(std::clamp(c.b, 0.0f, 255.0f) * 31.0f / 255.0f);
+    return (unsigned short)((r << 11) | (g << 5) | b);
+}
+
+static Rgba FromRgb565(unsigned short c)
+{
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    return { (float)((r << 3) | (r >> 2)), (float)((g << 2) | (g >> 4)), (float)((b << 3) | (b >> 2)), 255.0f };
+}
+
+// Picks the closest of the four palette colors per pixel, returns the total error
+static float FitIndices(const Rgba* pixels, unsigned short c0, unsigned short c1, unsigned int& indices)
+{
+    Rgba e0 = FromRgb565(c0), e1 = FromRgb565(c1);
+    Rgba palette[4] = {
+        e0, e1,
+        { (2 * e0.r + e1.r) / 3, (2 * e0.g + e1.g) / 3, (2 * e0.b + e1.b) / 3, 255 },
+        { (e0.r + 2 * e1.r) / 3, (e0.g + 2 * e1.g) / 3, (e0.b + 2 * e1.b) / 3, 255 }
+    };
+
+    float error = 0.0f;
+    indices = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        int best = 0;
+        float bestDistance = Distance(pixels[i], palette[0]);
+        for (int p = 1; p < 4; p++)
+        {
+            float distance = Distance(pixels[i], palette[p]);
+            if (distance < bestDistance)
+            {
+                best = p;
+                bestDistance = distance;
+            }
+        }
+        indices |= (unsigned int)best << (2 * i);
+        error += bestDistance;
+    }
+    return error;
+}
+
+// Orders the endpoints for the 4 color mode (c0 > c1), swapping indices to match
+static void WriteColorBlock(unsigned short c0, unsigned short c1, unsigned int indices, unsigned char* out)
+{
+    if (c0 < c1)
+    {
+        std::swap(c0, c1);
+        indices ^= 0x55555555u; // 0 <-> 1, 2 <-> 3
+    }
+    else if (c0 == c1)
+        indices = 0;
+
+    std::memcpy(out, &c0, 2);
+    std::memcpy(out + 2, &c1, 2);
+    std::memcpy(out + 4, &indices, 4);
+}
+
+// Endpoints along the principal axis of the colors, then one least squares refinement
+static void EncodeColorBlock(const Rgba* pixels, unsigned char* out)
+{
+    Rgba mean = { 0, 0, 0, 0 };
+    for (int i = 0; i < 16; i++)
+    {
+        mean.r += pixels[i].r / 16;
+        mean.g += pixels[i].g / 16;
+        mean.b += pixels[i].b / 16;
+    }
+
+    float cov[6] = { 0 }; // rr rg rb gg gb bb
+    for (int i = 0; i < 16; i++)
+    {
+        float r = pixels[i].r - mean.r, g = pixels[i].g - mean.g, b = pixels[i].b - mean.b;
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    float axis[3] = { 1, 1, 1 };
+    for (int iteration = 0; iteration < 8; iteration++)
+    {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float length = std::max({ std::fabs(x), std::fabs(y), std::fabs(z) });
+        if (length < 1e-6f)
+            break;
+        axis[0] = x / length; axis[1] = y / length; axis[2] = z / length;
+    }
+    float lengthSq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+
+    float minT = 0, maxT = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        float t = ((pixels[i].r - mean.r) * axis[0] + (pixels[i].g - mean.g) * axis[1] +
+                   (pixels[i].b - mean.b) * axis[2]) / lengthSq;
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+
+    // Pull the ends in a little, the extremes are usually outliers
+    float inset = (maxT - minT) / 16;
+    minT += inset;
+    maxT -= inset;
+    Rgba high = { mean.r + axis[0] * maxT, mean.g + axis[1] * maxT, mean.b + axis[2] * maxT, 255 };
+    Rgba low = { mean.r + axis[0] * minT, mean.g + axis[1] * minT, mean.b + axis[2] * minT, 255 };
+
+    unsigned short c0 = ToRgb565(high), c1 = ToRgb565(low);
+    unsigned int indices;
+    float error = FitIndices(pixels, c0, c1, indices);
+
+    // Solve for the endpoints that best reproduce the chosen indices
+    const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+    float aa = 0, ab = 0, bb = 0;
+    Rgba ax = { 0, 0, 0, 0 }, bx = { 0, 0, 0, 0 };
+    for (int i = 0; i < 16; i++)
+    {
+        float a = weights[(indices >> (2 * i)) & 3], b = 1.0f - a;
+        aa += a * a; ab += a * b; bb += b * b;
+        ax.r += a * pixels[i].r; ax.g += a * pixels[i].g; ax.b += a * pixels[i].b;
+        bx.r += b * pixels[i].r; bx.g += b * pixels[i].g; bx.b += b * pixels[i].b;
+    }
+
+    float det = aa * bb - ab * ab;
+    if (std::fabs(det) > 1e-6f)
+    {
+        Rgba refinedHigh = { (bb * ax.r - ab * bx.r) / det, (bb * ax.g - ab * bx.g) / det, (bb * ax.b - ab * bx.b) / det, 255 };
+        Rgba refinedLow = { (aa * bx.r - ab * ax.r) / det, (aa * bx.g - ab * ax.g) / det, (aa * bx.b - ab * ax.b) / det, 255 };
+
+        unsigned short r0 = ToRgb565(refinedHigh), r1 = ToRgb565(refinedLow);
+        unsigned int refinedIndices;
+        if (FitIndices(pixels, r0, r1, refinedIndices) < error)
+        {
+            c0 = r0;
+            c1 = r1;
+            indices = refinedIndices;
+        }
+    }
+
+    WriteColorBlock(c0, c1, indices, out);
+}
+
+// BC3 alpha: min/max endpoints with the 6 interpolated values in between
+static void EncodeAlphaBlock(const Rgba* pixels, unsigned char* out)
+{
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; i++)
+    {
+        a0 = std::max(a0, (int)pixels[i].a);
+        a1 = std::min(a1, (int)pixels[i].a);
+    }
+
+    int palette[8] = { a0, a1 };
+    for (int i = 2; i < 8; i++)
+        palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+
+    unsigned long long bits = 0;
+    for (int i = 0; a0 != a1 && i < 16; i++)
+    {
+        int best = 0;
+        for (int p = 1; p < 8; p++)
+        {
+            if (std::abs(palette[p] - (int)pixels[i].a) < std::abs(palette[best] - (int)pixels[i].a))
+                best = p;
+        }
+        bits |= (unsigned long long)best << (3 * i);
+    }
+
+    out[0] = (unsigned char)a0;
+    out[1] = (unsigned char)a1;
+    for (int i = 0; i < 6; i++)
+        out[2 + i] = (unsigned char)(bits >> (8 * i));
+}
+
+static std::vector<unsigned char> EncodeLevel(const unsigned char* rgba, int width, int height, KtxFormat format)
+{
+    int blockSize = KtxImage::GetBlockSize(format);
+    std::vector<unsigned char> blocks(KtxImage::GetLevelSize(format, width, height));
+
+    unsigned char* out = blocks.data();
+    for (int by = 0; by < height; by += 4)
+    {
+        for (int bx = 0; bx < width; bx += 4, out += blockSize)
+        {
+            // Blocks past the edge repeat the last row/column
+            Rgba pixels[16];
+            for (int i = 0; i < 16; i++)
+            {
+                int x = std::min(bx + i % 4, width - 1), y = std::min(by + i / 4, height - 1);
+                const unsigned char* p = rgba + ((size_t)y * width + x) * 4;
+                pixels[i] = { (float)p[0], (float)p[1], (float)p[2], (float)p[3] };
+            }
+
+            if (format == KtxFormat::BC3_RGBA)
+            {
+                EncodeAlphaBlock(pixels, out);
+                EncodeColorBlock(pixels, out + 8);
+            }
+            else
+                EncodeColorBlock(pixels, out);
+        }
+    }
+    return blocks;
+}
+
+// 2x2 box filter, odd sizes reuse the last row/column
+static std::vector<unsigned char> Downsample(const std::vector<unsigned char>& rgba, int width, int height)
+{
+    int w = std::max(1, width / 2), h = std::max(1, height / 2);
+    std::vector<unsigned char> result((size_t)w * h * 4);
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            int x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+            int y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+            for (int c = 0; c < 4; c++)
+            {
+                int sum = rgba[((size_t)y0 * width + x0) * 4 + c] + rgba[((size_t)y0 * width + x1) * 4 + c] +
+                          rgba[((size_t)y1 * width + x0) * 4 + c] + rgba[((size_t)y1 * width + x1) * 4 + c];
+                result[((size_t)y * w + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+            }
+        }
+    }
+    return result;
+}
+
+static bool Convert(const std::string& input, const std::string& formatName, bool mips)
+{
+    // Stored bottom-up like the textures the engine decodes itself
+    stbi_set_flip_vertically_on_load(1);
+    int width, height, components;
+    unsigned char* pixels = stbi_load(input.c_str(), &width, &height, &components, 4);
+    if (!pixels)
+    {
+        std::fprintf(stderr, "%s: %s\n", input.c_str(), stbi_failure_reason());
+        return false;
+    }
+    std::vector<unsigned char> rgba(pixels, pixels + (size_t)width * height * 4);
+    stbi_image_free(pixels);
+
+    KtxImage image;
+    image.width = width;
+    image.height = height;
+    image.format = formatName == "bc3" ? KtxFormat::BC3_RGBA : KtxFormat::BC1_RGB;
+    if (formatName == "auto")
+    {
+        for (size_t i = 3; i < rgba.size() && image.format == KtxFormat::BC1_RGB; i += 4)
+        {
+            if (rgba[i] != 255)
+                image.format = KtxFormat::BC3_RGBA;
+        }
+    }
+
+    int w = width, h = height;
+    while (true)
+    {
+        image.AddLevel(EncodeLevel(rgba.data(), w, h, image.format).data());
+        if (!mips || (w == 1 && h == 1))
+            break;
+        rgba = Downsample(rgba, w, h);
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+
+    std::string output = input.substr(0, input.find_last_of('.')) + ".ktx2";
+    std::string error;
+    if (!SaveKtx2(output, image, &error))
+    {
+        std::fprintf(stderr, "%s: %s\n", output.c_str(), error.c_str());
+        return false;
+    }
+
+    // Uncompressed RGBA8 with a full mip chain takes about 4/3 of the top level
+    size_t uncompressed = (size_t)width * height * 4 * (mips ? 4 : 3) / 3;
+    std::printf("%s -> %s: %dx%d %s, %d levels, %zu KB (RGBA8: %zu KB)\n", input.c_str(), output.c_str(), width, height,
+                image.format == KtxFormat::BC3_RGBA ? "BC3" : "BC1", (int)image.levels.size(),
+                image.data.size() / 1024, uncompressed / 1024);
+    return true;
+}
+
+static int PrintUsage(const char* program)
+{
+    std::fprintf(stderr, "Usage: %s [--format auto|bc1|bc3] [--no-mips] <image> [<image> ...]\n", program);
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    std::string format = "auto";
+    bool mips = true;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc)
+            format = argv[++i];
+        else if (arg == "--no-mips")
+            mips = false;
+        else if (arg.rfind("--", 0) == 0)
+            return PrintUsage(argv[0]);
+        else
+            inputs.push_back(arg);
+    }
+
+    if (inputs.empty() || (format != "auto" && format != "bc1" && format != "bc3"))
+        return PrintUsage(argv[0]);
+
+    int failed = 0;
+    for (const std::string& input : inputs)
+        failed += Convert(input, format, mips) ? 0 : 1;
+    return failed ? 1 : 0;
+}